@@ -0,0 +1,42 @@
+#!/bin/bash
+. ./config
+
+# The OF-CONFIG server is expected to run with the group commit enabled,
+# e.g. 'ofc-server -w 200', so the concurrent edit-configs of running are
+# committed in a single OVSDB transaction.
+
+COUNT=4
+
+KEYS=`eval echo eth{1..$COUNT}`
+
+./reset.sh
+./get-config.sh > start_state
+
+echo "Create multiple ports concurrently"
+for i in $KEYS; do
+  sed "s/eth1/$i/" create_port_eth1.xml > tempxml_$i
+  ./run_edit_config.sh tempxml_$i running &
+done
+wait
+check_startup_nonchange start_state
+./get-config.sh | tee before_change
+
+echo "Modify multiple ports concurrently"
+for i in $KEYS; do
+  sed "s/eth1/$i/" change_port_reqnum.xml > tempxml_$i
+  ./run_edit_config.sh tempxml_$i running &
+done
+wait
+check_startup_nonchange before_change
+
+echo "Remove multiple ports concurrently"
+for i in $KEYS; do
+  sed "s/eth1/$i/" remove_port_eth1.xml > tempxml_$i
+  ./run_edit_config.sh tempxml_$i running &
+done
+wait
+check_startup_difference start_state
+
+rm -f start_state before_change tempxml_*
+
+exit 0
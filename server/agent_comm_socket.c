@@ -200,8 +200,7 @@ comm_operation(comm_t *c, const nc_rpc *rpc)
     }
 
     /* get the reply message */
-    recv(*c, &len, sizeof len, OFC_SOCK_SENDFLAGS);
-    msg_dump = recv_msg(*c, len, &err);
+    msg_dump = recv_msg_chunked(*c, &err);
     if (err != NULL) {
         return nc_reply_error(err);
     }
@@ -24,26 +24,17 @@
 
 #include "comm_socket.h"
 
-char *
-recv_msg(int socket, size_t len, struct nc_err **err)
+/* Receive exactly 'len' bytes into 'buf'.  Returns EXIT_SUCCESS or
+ * EXIT_FAILURE and sets '*err' (if not NULL). */
+static int
+recv_all(int socket, char *buf, size_t len, struct nc_err **err)
 {
     size_t recv_len = 0;
     ssize_t ret = 0;
-    char *msg_dump;
 
-    msg_dump = malloc(sizeof (*msg_dump) * len);
-    if (msg_dump == NULL) {
-        nc_verb_error("Memory allocation failed - %s (%s:%d).",
-                      strerror(errno), __FILE__, __LINE__);
-        if (err) {
-            *err = nc_err_new(NC_ERR_OP_FAILED);
-            nc_err_set(*err, NC_ERR_PARAM_MSG, "Memory allocation failed.");
-        }
-        return NULL;
-    }
     while (recv_len < len) {
         /* recv in loop to pass transfer capacity of the socket */
-        ret = recv(socket, &(msg_dump[recv_len]), len - recv_len,
+        ret = recv(socket, &(buf[recv_len]), len - recv_len,
                    OFC_SOCK_SENDFLAGS);
         if (ret <= 0) {
             if (ret == 0) {
@@ -61,11 +52,124 @@ recv_msg(int socket, size_t len, struct nc_err **err)
                 nc_err_set(*err, NC_ERR_PARAM_MSG,
                            "agent-server communication failed.");
             }
-            free(msg_dump);
-            return NULL;
+            return EXIT_FAILURE;
         }
         recv_len += ret;
     }
 
+    return EXIT_SUCCESS;
+}
+
+char *
+recv_msg(int socket, size_t len, struct nc_err **err)
+{
+    char *msg_dump;
+
+    msg_dump = malloc(sizeof (*msg_dump) * len);
+    if (msg_dump == NULL) {
+        nc_verb_error("Memory allocation failed - %s (%s:%d).",
+                      strerror(errno), __FILE__, __LINE__);
+        if (err) {
+            *err = nc_err_new(NC_ERR_OP_FAILED);
+            nc_err_set(*err, NC_ERR_PARAM_MSG, "Memory allocation failed.");
+        }
+        return NULL;
+    }
+    if (recv_all(socket, msg_dump, len, err)) {
+        free(msg_dump);
+        return NULL;
+    }
+
     return (msg_dump);
 }
+
+/* Send all 'len' bytes of 'buf', partial sends are completed. */
+static int
+send_all(int socket, const void *buf, size_t len)
+{
+    const char *p = buf;
+    ssize_t ret;
+
+    while (len) {
+        ret = send(socket, p, len, OFC_SOCK_SENDFLAGS);
+        if (ret == -1) {
+            if (errno == EAGAIN || errno == EINTR) {
+                continue;
+            }
+            nc_verb_error("Communication failed, %s", strerror(errno));
+            return EXIT_FAILURE;
+        }
+        p += ret;
+        len -= ret;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int
+send_msg_chunked(int socket, const char *msg, size_t len)
+{
+    unsigned int chunk;
+
+    do {
+        chunk = len > COMM_SOCK_CHUNK_SIZE ? COMM_SOCK_CHUNK_SIZE : len;
+        if (send_all(socket, &chunk, sizeof chunk)
+            || send_all(socket, msg, chunk)) {
+            return EXIT_FAILURE;
+        }
+        msg += chunk;
+        len -= chunk;
+    } while (chunk);
+
+    return EXIT_SUCCESS;
+}
+
+char *
+recv_msg_chunked(int socket, struct nc_err **err)
+{
+    unsigned int chunk;
+    size_t len = 0;
+    char *msg = NULL, *aux;
+
+    for (;;) {
+        if (recv_all(socket, (char *) &chunk, sizeof chunk, err)) {
+            free(msg);
+            return NULL;
+        }
+        if (chunk > COMM_SOCK_CHUNK_SIZE) {
+            nc_verb_error("Communication failed, invalid chunk size %u.",
+                          chunk);
+            goto error;
+        }
+
+        /* the buffer always keeps space for the terminating null byte */
+        aux = realloc(msg, len + chunk + 1);
+        if (aux == NULL) {
+            nc_verb_error("Memory allocation failed - %s (%s:%d).",
+                          strerror(errno), __FILE__, __LINE__);
+            goto error;
+        }
+        msg = aux;
+        if (!chunk) {
+            break;
+        }
+
+        if (recv_all(socket, msg + len, chunk, err)) {
+            free(msg);
+            return NULL;
+        }
+        len += chunk;
+    }
+    msg[len] = '\0';
+
+    return msg;
+
+error:
+    if (err) {
+        *err = nc_err_new(NC_ERR_OP_FAILED);
+        nc_err_set(*err, NC_ERR_PARAM_MSG,
+                   "agent-server communication failed.");
+    }
+    free(msg);
+    return NULL;
+}
@@ -36,6 +36,24 @@ typedef int comm_t;
 
 typedef int msgtype_t;
 
+/* maximal size of a chunk of the messages sent by send_msg_chunked() */
+#define COMM_SOCK_CHUNK_SIZE 65536
+
+/*
+ * Send a message of any size as a sequence of chunks, each preceded by its
+ * length (unsigned int), terminated by an empty chunk.  The receiver does
+ * not need to know the size of the message in advance.  The chunks only
+ * frame the message on the socket, the message itself is complete in memory
+ * on both sides.
+ */
+int send_msg_chunked(int socket, const char *msg, size_t len);
+
+/*
+ * Receive a message sent by send_msg_chunked(), the returned string is
+ * null-terminated and must be freed by the caller.
+ */
+char *recv_msg_chunked(int socket, struct nc_err **err);
+
 enum COMM_SOCKET_MSGTYPE {
 	COMM_SOCK_RESULT_ERROR = -1,
 	COMM_SOCK_GET_CPBLTS = 1,
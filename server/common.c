@@ -14,10 +14,15 @@
  * limitations under the License.
  */
 
+#include <config.h>
+
+#include <stdlib.h>
 #include <syslog.h>
 
 #include <libnetconf.h>
 
+#include "common.h"
+
 void
 clb_print(NC_VERB_LEVEL level, const char *msg)
 {
@@ -36,3 +41,79 @@ clb_print(NC_VERB_LEVEL level, const char *msg)
         break;
     }
 }
+
+/* default size of the arena blocks, larger allocations get their own block */
+#define ARENA_BLOCK_SIZE 65536
+
+/* alignment of the allocated memory */
+#define ARENA_ALIGN (sizeof(long double))
+
+struct ofc_arena_block {
+    struct ofc_arena_block *next;
+    size_t size;                /* usable size of 'data' */
+    size_t used;
+    long double data[];         /* aligned */
+};
+
+void *
+ofc_arena_alloc(struct ofc_arena *arena, size_t size)
+{
+    struct ofc_arena_block *block = arena->blocks;
+    size_t block_size;
+    void *p;
+
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    if (!block || block->size - block->used < size) {
+        block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        block = malloc(sizeof *block + block_size);
+        if (!block) {
+            nc_verb_error("Memory allocation failed (%s).", __func__);
+            return NULL;
+        }
+        block->size = block_size;
+        block->used = 0;
+        block->next = arena->blocks;
+        arena->blocks = block;
+    }
+
+    p = (char *) block->data + block->used;
+    block->used += size;
+    arena->used += size;
+
+    return p;
+}
+
+void
+ofc_arena_reset(struct ofc_arena *arena)
+{
+    struct ofc_arena_block *block;
+
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+#ifdef OFC_ARENA_STATS
+    if (arena->used) {
+        nc_verb_verbose("Arena %s: %zu bytes used, high-water mark %zu bytes.",
+                        arena->name, arena->used, arena->high_water);
+    }
+#endif
+    arena->used = 0;
+
+    /* keep a single block for the next request */
+    while (arena->blocks && arena->blocks->next) {
+        block = arena->blocks;
+        arena->blocks = block->next;
+        free(block);
+    }
+    if (arena->blocks) {
+        arena->blocks->used = 0;
+    }
+}
+
+void
+ofc_arena_destroy(struct ofc_arena *arena)
+{
+    ofc_arena_reset(arena);
+    free(arena->blocks);
+    arena->blocks = NULL;
+}
@@ -17,10 +17,35 @@
 #ifndef OFC_COMMON_H_
 #define OFC_COMMON_H_
 
+#include <stddef.h>
+
 /* Environment variable with settings for verbose level */
 #define ENVIRONMENT_VERBOSE "OFC_VERBOSE"
 
 /* verbose messages printer */
 void clb_print(NC_VERB_LEVEL level, const char *msg);
 
+/*
+ * Memory arena for the short-lived data of a request.  The data are allocated
+ * from large blocks and they are all released at once by ofc_arena_reset(),
+ * so they must not be freed individually.  The reset keeps a block for the
+ * next request.  With --enable-arena-stats, the usage and the high-water
+ * mark of the arena are reported on reset.
+ */
+struct ofc_arena {
+    const char *name;           /* Name for the statistics. */
+    struct ofc_arena_block *blocks; /* The current block is the first one. */
+    size_t used;                /* Bytes allocated since the last reset. */
+    size_t high_water;          /* Maximum of 'used' over the resets. */
+};
+
+#define OFC_ARENA_INITIALIZER(NAME) {NAME, NULL, 0, 0}
+
+/* Returns NULL if the memory cannot be allocated. */
+void *ofc_arena_alloc(struct ofc_arena *arena, size_t size);
+
+void ofc_arena_reset(struct ofc_arena *arena);
+
+void ofc_arena_destroy(struct ofc_arena *arena);
+
 #endif /* OFC_COMMON_H_ */
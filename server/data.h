@@ -64,6 +64,15 @@ xmlNodePtr go2node(xmlNodePtr parent, xmlChar *name);
 
 const xmlChar *get_key(xmlNodePtr parent, const char *name);
 
+/*
+ * Analyse the subtree filter of the <get> or <get-config> 'rpc' and limit the
+ * generated data to the parts the filter can select.  ofc_filter_clear()
+ * must be called when the request is processed.
+ */
+void ofc_filter_set(const nc_rpc *rpc);
+
+void ofc_filter_clear(void);
+
 /*
  * Get the operation value from the node, if not present, it tries to get it
  * from parents. If no operation set, it returns defop
@@ -77,9 +86,114 @@ NC_EDIT_OP_TYPE edit_op_get(xmlNodePtr node, NC_EDIT_DEFOP_TYPE defop,
 
 bool ofc_init(const char *ovs_db_path);
 
+/*
+ * Parts of the data that can be requested separately
+ */
+#define OFC_DATA_PORTS          0x0001
+#define OFC_DATA_QUEUES         0x0002
+#define OFC_DATA_OWNED_CERT     0x0004
+#define OFC_DATA_EXTERNAL_CERT  0x0008
+#define OFC_DATA_FLOW_TABLES    0x0010
+#define OFC_DATA_SWITCHES       0x0020
+#define OFC_DATA_RESOURCES      (OFC_DATA_PORTS | OFC_DATA_QUEUES \
+                                 | OFC_DATA_OWNED_CERT \
+                                 | OFC_DATA_EXTERNAL_CERT \
+                                 | OFC_DATA_FLOW_TABLES)
+#define OFC_DATA_CONFIG         (OFC_DATA_RESOURCES | OFC_DATA_SWITCHES)
+
+/*
+ * Parts of the state data that need additional probes of the switch, they
+ * are generated only together with their section above
+ */
+#define OFC_DATA_PORT_OF        0x0100  /* OpenFlow port description */
+#define OFC_DATA_PORT_FEATURES  0x0200  /* ethtool of the interface */
+#define OFC_DATA_CAPABILITIES   0x0400  /* switch capabilities */
+#define OFC_DATA_CONTROLLERS    0x0800  /* controller connection state */
+#define OFC_DATA_PORT_STATS     0x1000  /* OpenFlow port counters */
+#define OFC_DATA_QUEUE_STATS    0x2000  /* OpenFlow queue counters */
+#define OFC_DATA_FLOW_TABLE_STATS 0x4000 /* OpenFlow table counters */
+#define OFC_DATA_PORT_PROBES    (OFC_DATA_PORT_OF | OFC_DATA_PORT_FEATURES \
+                                 | OFC_DATA_PORT_STATS)
+#define OFC_DATA_SWITCH_PROBES  (OFC_DATA_CAPABILITIES | OFC_DATA_CONTROLLERS)
+
+#define OFC_DATA_ALL            0xffff
+
+/*
+ * Limit the data generated for the current request to the 'sections' (a mask
+ * of OFC_DATA_* values) and, if 'switches' is not NULL, to the logical
+ * switches with ids listed in the NULL terminated 'switches' array.  The
+ * array must stay valid until the filter is reset by
+ * ofc_set_data_filter(OFC_DATA_ALL, NULL).
+ */
+void ofc_set_data_filter(unsigned int sections, char **switches);
+
 char *ofc_get_state_data(void);
 
+/*
+ * Sample the state data by ofc_run() every 'interval' ms (0 disables the
+ * sampling) and serve <get> from the last sample unless it is older than
+ * 'max_staleness' ms (0 means twice the interval).  The served data carry
+ * the age of the sample in /capable-switch/sample-age.  The sample is
+ * refreshed sooner, but at most once a second, when OVSDB or a network
+ * interface changes.
+ */
+void ofc_set_state_sampling(int interval, int max_staleness);
+
+/*
+ * True if the state data are served from a sample, so they do not show the
+ * changes of a commit in progress.
+ */
+bool ofc_state_sampled(void);
+
+/*
+ * True while the replies of the bridges to a state sample are awaited, the
+ * sample is finished by a later ofc_run().
+ */
+bool ofc_state_sample_pending(void);
+
 char *ofc_get_config_data(void);
+
+/*
+ * Get the state data and the running configuration as parsed documents.
+ * Both are generated as XML strings and parsed; the running configuration and
+ * the state data sample are parsed only once, the caller gets a copy of the
+ * cached tree.
+ * ofc_get_config_doc() returns EXIT_FAILURE if the data are not available,
+ * '*doc' is NULL if there are no data.
+ */
+xmlDocPtr ofc_get_state_doc(void);
+
+int ofc_get_config_doc(xmlDocPtr *doc);
+
+/*
+ * Get the running configuration as a document owned by this module, the
+ * caller patches it in place by the edit it applies to OVSDB and hands it
+ * back by ofc_put_running_doc().  Returns EXIT_FAILURE if the data are not
+ * available, '*doc' is NULL if there are no data.
+ */
+int ofc_get_running_doc(xmlDocPtr *doc);
+
+/*
+ * Finish the edit of the document from ofc_get_running_doc().  'doc' is the
+ * patched document (a new one if there were no data).  If the edit was
+ * 'committed', 'doc' becomes the running configuration, otherwise it is
+ * dropped and the document is rebuilt for the next edit.
+ */
+void ofc_put_running_doc(xmlDocPtr doc, bool committed);
+
+/*
+ * Set how long (ms) a configuration change waits for the bridge to become
+ * reachable via OpenFlow.  Reading the data never waits, the OpenFlow part of
+ * the data of a not connected bridge is omitted.
+ */
+void ofc_set_of_timeout(int msec);
+
+/*
+ * Periodic maintenance of the OVS connections, to be called from the
+ * server's main loop.
+ */
+void ofc_run(void);
+
 int ofc_check_bridge_queue(const xmlChar *br_name, const xmlChar *queue_rid);
 
 int of_mod_port_cfg(const xmlChar *port_name, const xmlChar *bit_xchar, const xmlChar *value, struct nc_err **e);
@@ -158,6 +272,65 @@ void txn_abort(void);
  */
 int txn_commit(struct nc_err **e);
 
+/*
+ * Commit the current transaction of an edit of 'running' (the document from
+ * ofc_get_running_doc()) without waiting for OVSDB.  When the commit
+ * succeeds, of_post_ports() is applied to 'post_ports' (if not NULL); both
+ * documents are then taken over.  Returns the final result if OVSDB did not
+ * have to be asked, otherwise EXIT_SUCCESS and the commit is finished by
+ * ofc_run(), see ofc_commit_done().  Inside a group, the edit is only added
+ * to the group's transaction.
+ */
+int txn_commit_start(xmlDocPtr running, xmlDocPtr post_ports,
+                     struct nc_err **e);
+
+/*
+ * Start a group of edits sharing a single transaction: txn_init() continues
+ * with the transaction of the group and txn_commit_start() collects the
+ * edits until txn_group_end().
+ */
+void txn_group_begin(void);
+
+/*
+ * Commit the transaction of the group like txn_commit_start().  The results
+ * of the particular edits are available from ofc_commit_edit_result().
+ */
+int txn_group_end(struct nc_err **e);
+
+/*
+ * Abort the transaction of the group and forget its edits, e.g. when one of
+ * them failed.
+ */
+void txn_group_abort(void);
+
+/*
+ * True from the start of a commit by txn_commit_start() until its result is
+ * collected by ofc_commit_done().
+ */
+bool ofc_commit_pending(void);
+
+/*
+ * Collect the result of the commit started by txn_commit_start().  Returns
+ * false while the commit is in progress, otherwise true with the result in
+ * 'ret' and the error (to be freed by the caller) in 'e'.
+ */
+bool ofc_commit_done(int *ret, struct nc_err **e);
+
+/*
+ * Get the id of the edit last added to a commit by txn_commit_start(), 0 if
+ * there was none yet.  A request whose processing does not change the id did
+ * not reach txn_commit_start().
+ */
+unsigned int ofc_commit_last_edit(void);
+
+/*
+ * Get the result of the edit 'id' (see ofc_commit_last_edit()) of the last
+ * commit, e.g. the OpenFlow changes after a successful transaction.  The
+ * error is handed over to the caller.  Edits not found in the last commit
+ * succeeded.
+ */
+int ofc_commit_edit_result(unsigned int id, struct nc_err **e);
+
 /*
  * local-data.c
  */
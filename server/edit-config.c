@@ -17,9 +17,8 @@
 #include <ctype.h>
 #include <string.h>
 
+#include <libxml/hash.h>
 #include <libxml/tree.h>
-#include <libxml/xpath.h>
-#include <libxml/xpathInternals.h>
 
 #include <libnetconf.h>
 
@@ -27,50 +26,68 @@
 
 #define NC_NS_BASE10        "urn:ietf:params:xml:ns:netconf:base:1.0"
 
-#define XPATH_BUFFER 1024
-
 static int edit_replace(xmlDocPtr, xmlNodePtr, int, struct nc_err **);
 static int edit_delete(xmlNodePtr, int, int, struct nc_err **);
+static int edit_delete_equiv(xmlDocPtr, xmlNodePtr, int, struct nc_err **);
 static int edit_remove(xmlDocPtr, xmlNodePtr, int, struct nc_err **);
 static int edit_create(xmlDocPtr, xmlNodePtr, int, struct nc_err **);
 static int edit_merge(xmlDocPtr, xmlNodePtr, int, struct nc_err **);
 
 /*
- * Remove leading and trailing whitespaces from the string.
+ * Explicit edit-config's operations in the order they are applied by
+ * edit_operations()
+ */
+static const struct {
+    NC_EDIT_OP_TYPE op;
+    const char *name;           /* value of the operation attribute */
+    const char *log;
+    int (*apply)(xmlDocPtr, xmlNodePtr, int, struct nc_err **);
+} edit_phases[] = {
+    {NC_EDIT_OP_DELETE, "delete", "delete", edit_delete_equiv},
+    {NC_EDIT_OP_REMOVE, "remove", "remove", edit_remove},
+    {NC_EDIT_OP_REPLACE, "replace", "replace", edit_replace},
+    {NC_EDIT_OP_CREATE, "create", "create", edit_create},
+    {NC_EDIT_OP_MERGE, "merge", "explicit merge", edit_merge},
+};
+
+#define EDIT_N_PHASES ((int) (sizeof edit_phases / sizeof edit_phases[0]))
+
+/*
+ * Skip leading and trailing whitespaces of the string without modifying it.
  *
- * @param[in] in Input string to clear.
- * @return copy of the input string without leading/trailing whitespaces,
- * NULL on memory allocation error. Caller is supposed to free the returned
- * string.
+ * @param[in] in Input string.
+ * @param[out] len Length of the string without the trailing whitespaces.
+ * @return pointer to the first non-whitespace character of the input string.
  */
-static char *
-clrwspace(const char *in)
+static const char *
+strtrim(const char *in, size_t *len)
 {
-    int i, j = 0, len = strlen(in);
-    char *retval = strdup(in);
+    size_t n;
 
-    if (retval == NULL) {
-        nc_verb_error("Memory allocation failed (%s).", __func__);
-        return (NULL);
+    while (isspace((unsigned char) *in)) {
+        in++;
     }
-
-    if (isspace(retval[0])) {
-        /* remove leading whitespace characters */
-        for (i = 0, j = 0; i < len; i++, j++) {
-            while (retval[i] != '\0' && isspace(retval[i])) {
-                i++;
-            }
-            retval[j] = retval[i];
-        }
+    for (n = strlen(in); n > 0 && isspace((unsigned char) in[n - 1]); n--) {
     }
+    *len = n;
 
-    /* remove trailing whitespace characters */
-    while (j >= 0 && isspace(retval[j])) {
-        retval[j] = '\0';
-        j--;
-    }
+    return in;
+}
+
+/*
+ * Compare 2 strings ignoring their leading and trailing whitespaces.
+ *
+ * @return 1 if the strings match, 0 otherwise.
+ */
+static int
+strtrimeq(const char *s1, const char *s2)
+{
+    size_t len1, len2;
+
+    s1 = strtrim(s1, &len1);
+    s2 = strtrim(s2, &len2);
 
-    return (retval);
+    return (len1 == len2 && !strncmp(s1, s2, len1));
 }
 
 /*
@@ -87,7 +104,7 @@ static int
 nscmp(xmlNodePtr reference, xmlNodePtr node)
 {
     int in_ns = 1;
-    char *s = NULL;
+    size_t len;
 
     if (reference->ns != NULL && reference->ns->href != NULL) {
 
@@ -97,11 +114,9 @@ nscmp(xmlNodePtr reference, xmlNodePtr node)
          * 2) namespace is empty: xmlns=""
          */
         if (!strcmp((char *) reference->ns->href, NC_NS_BASE10) ||
-            strlen(s = clrwspace((char *) (reference->ns->href))) == 0) {
-            free(s);
+            *strtrim((char *) reference->ns->href, &len) == '\0') {
             return 0;
         }
-        free(s);
 
         in_ns = 0;
         if (node->ns != NULL) {
@@ -252,73 +267,155 @@ get_defval(xmlNodePtr node)
     return NULL;
 }
 
-/**
- * \brief Get the list of elements with the specified selected edit-config's
- * operation.
- *
- * \param[in] op edit-config's operation type to search for.
- * \param[in] edit XML document covering edit-config's \<config\> element. The
- *                 elements with specified operation will be searched for in
- *                 this document.
+/* Element with an explicit operation */
+struct edit_op {
+    xmlNodePtr node;
+    int nested;     /* inside an element applied in an earlier or the same
+                     * phase, which consumes the element with its subtree */
+};
+
+/* Elements with an explicit operation, per edit_phases[] entry and in the
+ * document order */
+struct edit_ops {
+    struct edit_op *nodes[EDIT_N_PHASES];
+    int n[EDIT_N_PHASES];
+    int size[EDIT_N_PHASES];
+};
+
+/*
+ * Get the edit_phases[] index of the explicit operation of the node, -1 if
+ * the node has no (valid) operation attribute.
  */
-static xmlXPathObjectPtr
-get_operation_elements(NC_EDIT_OP_TYPE op, xmlDocPtr edit)
+static int
+get_operation_phase(xmlNodePtr node)
 {
-    xmlXPathContextPtr edit_ctxt = NULL;
-    xmlXPathObjectPtr operation_nodes = NULL;
-    char xpath[XPATH_BUFFER];
-    char *opstring;
-
-    switch (op) {
-    case NC_EDIT_OP_MERGE:
-        opstring = "merge";
-        break;
-    case NC_EDIT_OP_REPLACE:
-        opstring = "replace";
-        break;
-    case NC_EDIT_OP_CREATE:
-        opstring = "create";
-        break;
-    case NC_EDIT_OP_DELETE:
-        opstring = "delete";
-        break;
-    case NC_EDIT_OP_REMOVE:
-        opstring = "remove";
-        break;
-    default:
-        nc_verb_error("Unsupported edit operation %d (%s)", op, __func__);
-        return (NULL);
+    xmlAttrPtr attr;
+    int i;
+
+    if (node->type != XML_ELEMENT_NODE) {
+        return -1;
     }
+    attr = xmlHasNsProp(node, BAD_CAST "operation", BAD_CAST NC_NS_BASE10);
+    if (!attr || attr->type != XML_ATTRIBUTE_NODE || !attr->children) {
+        return -1;
+    }
+    for (i = 0; i < EDIT_N_PHASES; i++) {
+        if (xmlStrEqual(attr->children->content,
+                        BAD_CAST edit_phases[i].name)) {
+            return i;
+        }
+    }
+    return -1;
+}
 
-    /* create xpath evaluation context */
-    edit_ctxt = xmlXPathNewContext(edit);
-    if (edit_ctxt == NULL) {
-        if (edit_ctxt != NULL) {
-            xmlXPathFreeContext(edit_ctxt);
+static int
+get_phase_index(NC_EDIT_OP_TYPE op)
+{
+    int i;
+
+    for (i = 0; i < EDIT_N_PHASES; i++) {
+        if (edit_phases[i].op == op) {
+            return i;
         }
-        nc_verb_error("Creating the XPath evaluation context failed (%s).",
-                      __func__);
-        return (NULL);
     }
+    return -1;
+}
 
-    if (xmlXPathRegisterNs(edit_ctxt, BAD_CAST "nc", BAD_CAST NC_NS_BASE10)) {
-        xmlXPathFreeContext(edit_ctxt);
-        nc_verb_error("Registering a namespace for XPath failed (%s).",
-                      __func__);
-        return (NULL);
+static int
+edit_ops_add(struct edit_ops *ops, int phase, xmlNodePtr node, int nested)
+{
+    struct edit_op *nodes;
+    int size;
+
+    if (ops->n[phase] == ops->size[phase]) {
+        size = ops->size[phase] ? 2 * ops->size[phase] : 8;
+        nodes = realloc(ops->nodes[phase], size * sizeof *nodes);
+        if (nodes == NULL) {
+            nc_verb_error("Memory allocation failed (%s).", __func__);
+            return EXIT_FAILURE;
+        }
+        ops->nodes[phase] = nodes;
+        ops->size[phase] = size;
     }
+    ops->nodes[phase][ops->n[phase]].node = node;
+    ops->nodes[phase][ops->n[phase]].nested = nested;
+    ops->n[phase]++;
+    return EXIT_SUCCESS;
+}
 
-    if (snprintf(xpath, XPATH_BUFFER, "//*[@nc:operation='%s']", opstring) <= 0) {
-        xmlXPathFreeContext(edit_ctxt);
-        nc_verb_error("Preparing the XPath query failed (%s).", __func__);
-        return (NULL);
+/*
+ * Forget the node and its descendants, e.g. when the node is removed from the
+ * edit document.
+ */
+static void
+edit_ops_remove(struct edit_ops *ops, xmlNodePtr node)
+{
+    xmlNodePtr iter;
+    int phase, i, j;
+
+    for (phase = 0; phase < EDIT_N_PHASES; phase++) {
+        for (i = j = 0; i < ops->n[phase]; i++) {
+            for (iter = ops->nodes[phase][i].node; iter && iter != node;
+                 iter = iter->parent);
+            if (iter == NULL) {
+                ops->nodes[phase][j++] = ops->nodes[phase][i];
+            }
+        }
+        ops->n[phase] = j;
     }
-    operation_nodes = xmlXPathEvalExpression(BAD_CAST xpath, edit_ctxt);
+}
 
-    /* clean up */
-    xmlXPathFreeContext(edit_ctxt);
+/*
+ * Recursive follow-up of the collect_edit_ops()
+ *
+ * @param[in] node First sibling to process (recursively)
+ * @param[in] limit The lowest phase of the node's ancestors with an
+ * operation, EDIT_N_PHASES if there is none.
+ */
+static int
+collect_edit_ops_r(xmlNodePtr node, struct edit_ops *ops, int limit)
+{
+    int phase, children_limit;
+
+    for (; node != NULL; node = node->next) {
+        phase = get_operation_phase(node);
+        if (phase >= 0
+            && edit_ops_add(ops, phase, node, phase >= limit)) {
+            return EXIT_FAILURE;
+        }
+        children_limit = (phase >= 0 && phase < limit) ? phase : limit;
+        if (collect_edit_ops_r(node->children, ops, children_limit)) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
 
-    return (operation_nodes);
+/*
+ * Collect the elements with an explicit edit-config's operation from the
+ * edit document in a single walk.
+ *
+ * @param[in] edit XML document covering edit-config's \<config\> element.
+ * @param[out] ops Lists of the elements, to be freed by edit_ops_destroy()
+ * (also on failure).
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE
+ */
+static int
+collect_edit_ops(xmlDocPtr edit, struct edit_ops *ops)
+{
+    memset(ops, 0, sizeof *ops);
+    return collect_edit_ops_r(edit->children, ops, EDIT_N_PHASES);
+}
+
+static void
+edit_ops_destroy(struct edit_ops *ops)
+{
+    int i;
+
+    for (i = 0; i < EDIT_N_PHASES; i++) {
+        free(ops->nodes[i]);
+    }
 }
 
 /**
@@ -391,6 +488,58 @@ is_key(xmlNodePtr node)
     return 0;
 }
 
+/*
+ * Tell if the instances of the element are identified by their text value
+ * (leaf-list items and leafrefs in the logical switch's resources).
+ *
+ * @param[in] node XML element to analyze
+ * @return 0 as false, 1 as true
+ */
+static int
+is_leaflist_item(xmlNodePtr node)
+{
+    return (xmlStrEqual(node->name, BAD_CAST "queue")
+            || xmlStrEqual(node->name, BAD_CAST "flow-table")
+            || xmlStrEqual(node->name, BAD_CAST "rate")
+            || xmlStrEqual(node->name, BAD_CAST "medium")
+            || (xmlStrEqual(node->name, BAD_CAST "port") && node->parent
+                && xmlStrEqual(node->parent->name, BAD_CAST "resources")));
+}
+
+/*
+ * Get the name of the key identifying the list instance.
+ *
+ * @param[in] node XML element to analyze
+ * @return name of the key element, NULL if the node is not a list instance.
+ */
+static const char *
+get_list_key_name(xmlNodePtr node)
+{
+    xmlNodePtr grandparent;
+
+    if (xmlStrEqual(node->name, BAD_CAST "controller")
+        || xmlStrEqual(node->name, BAD_CAST "switch")) {
+        return "id";
+    }
+
+    grandparent = node->parent ? node->parent->parent : NULL;
+    if (!grandparent
+        || !xmlStrEqual(grandparent->name, BAD_CAST "capable-switch")) {
+        return NULL;
+    }
+    if (xmlStrEqual(node->name, BAD_CAST "port")) {
+        return "name";
+    } else if (xmlStrEqual(node->name, BAD_CAST "flow-table")) {
+        return "table-id";
+    } else if (xmlStrEqual(node->name, BAD_CAST "queue")
+               || xmlStrEqual(node->name, BAD_CAST "owned-certificate")
+               || xmlStrEqual(node->name, BAD_CAST "external-certificate")) {
+        return "resource-id";
+    }
+
+    return NULL;
+}
+
 /**
  * \brief Compare 2 elements and decide if they are equal for NETCONF.
  *
@@ -408,8 +557,7 @@ static int
 matching_elements(xmlNodePtr node1, xmlNodePtr node2)
 {
     xmlNodePtr key1, key2;
-    char *aux1, *aux2;
-    int ret;
+    const char *key_name;
 
     if (!node1 || !node2) {
         return -1;
@@ -417,17 +565,7 @@ matching_elements(xmlNodePtr node1, xmlNodePtr node2)
 
     /* compare text nodes */
     if (node1->type == XML_TEXT_NODE && node2->type == XML_TEXT_NODE) {
-        aux1 = clrwspace((char *) (node1->content));
-        aux2 = clrwspace((char *) (node2->content));
-
-        if (strcmp(aux1, aux2) == 0) {
-            ret = 1;
-        } else {
-            ret = 0;
-        }
-        free(aux1);
-        free(aux2);
-        return ret;
+        return strtrimeq((char *) node1->content, (char *) node2->content);
     }
 
     /* check element types - only element nodes are processed */
@@ -448,12 +586,7 @@ matching_elements(xmlNodePtr node1, xmlNodePtr node2)
      * if required, check children text node if exists, this is usually needed
      * for leaf-list's items
      */
-    if (xmlStrEqual(node2->name, BAD_CAST "queue")
-        || xmlStrEqual(node2->name, BAD_CAST "flow-table")
-        || xmlStrEqual(node2->name, BAD_CAST "rate")
-        || xmlStrEqual(node2->name, BAD_CAST "medium")
-        || (xmlStrEqual(node2->name, BAD_CAST "port")
-            && xmlStrEqual(node2->parent->name, BAD_CAST "resources"))) {
+    if (is_leaflist_item(node2)) {
         if (node1->children != NULL && node1->children->type == XML_TEXT_NODE
             && node2->children != NULL
             && node2->children->type == XML_TEXT_NODE) {
@@ -466,31 +599,13 @@ matching_elements(xmlNodePtr node1, xmlNodePtr node2)
     }
 
     /* check keys in lists */
-    aux1 = NULL;
-    if (xmlStrEqual(node2->name, BAD_CAST "controller")
-        || xmlStrEqual(node2->name, BAD_CAST "switch")) {
-        aux1 = "id";
-    } else if (xmlStrEqual(node2->name, BAD_CAST "port")
-               && xmlStrEqual(node2->parent->parent->name,
-                           BAD_CAST "capable-switch")) {
-        aux1 = "name";
-    } else if (xmlStrEqual(node2->name, BAD_CAST "flow-table")
-               && xmlStrEqual(node2->parent->parent->name,
-                           BAD_CAST "capable-switch")) {
-        aux1 = "table-id";
-    } else if ((xmlStrEqual(node2->name, BAD_CAST "queue")
-                || xmlStrEqual(node2->name, BAD_CAST "owned-certificate")
-                || xmlStrEqual(node2->name, BAD_CAST "external-certificate"))
-               && xmlStrEqual(node2->parent->parent->name,
-                              BAD_CAST "capable-switch")) {
-        aux1 = "resource-id";
-    } else {
+    if ((key_name = get_list_key_name(node2)) == NULL) {
         return 1;
     }
 
     /* evaluate keys */
-    key1 = go2node(node1, BAD_CAST aux1);
-    key2 = go2node(node2, BAD_CAST aux1);
+    key1 = go2node(node1, BAD_CAST key_name);
+    key2 = go2node(node2, BAD_CAST key_name);
     if (!key1 || !key2) {
         return 0;
     } else {
@@ -499,6 +614,205 @@ matching_elements(xmlNodePtr node1, xmlNodePtr node2)
     }
 }
 
+/* maximal length of the key value stored in the index */
+#define EQUIV_KEY_MAX 256
+
+/*
+ * Index of the list instances (and leaf-list items) of a configuration
+ * document by their parent, name and key value. It replaces the linear scan
+ * of the siblings in find_element_equiv(). The parents are indexed lazily on
+ * their first lookup; edit_create() and edit_delete() keep the index up to
+ * date, any other change of the document requires equiv_index_reset().
+ */
+static struct {
+    xmlDocPtr doc;              /* indexed document */
+    xmlHashTablePtr nodes;      /* (name, key value, parent) -> node */
+    xmlHashTablePtr parents;    /* parent -> parent or EQUIV_LINEAR */
+} equiv_index;
+
+/* marker of the parents whose children must be scanned linearly */
+static const char equiv_linear;
+#define EQUIV_LINEAR ((void *) &equiv_linear)
+
+/* Drop the index, it is rebuilt on the next lookup */
+static void
+equiv_index_reset(void)
+{
+    xmlHashFree(equiv_index.nodes, NULL);
+    xmlHashFree(equiv_index.parents, NULL);
+    memset(&equiv_index, 0, sizeof equiv_index);
+}
+
+/*
+ * Get the trimmed key value of the list instance (or leaf-list item).
+ *
+ * @param[in] node XML element to analyze
+ * @param[out] buf Buffer of EQUIV_KEY_MAX bytes for the key value.
+ * @return 1 if the value is stored in buf, 0 if the node is not a list
+ * instance, -1 if it is but it cannot be identified by the index.
+ */
+static int
+equiv_index_key(xmlNodePtr node, char *buf)
+{
+    const char *key_name, *value;
+    xmlNodePtr key;
+    size_t len;
+
+    if (node->type != XML_ELEMENT_NODE) {
+        return 0;
+    }
+
+    key = NULL;
+    if (is_leaflist_item(node) && node->children
+        && node->children->type == XML_TEXT_NODE) {
+        key = node->children;
+    } else if ((key_name = get_list_key_name(node)) != NULL) {
+        key = go2node(node, BAD_CAST key_name);
+        key = key ? key->children : NULL;
+    } else if (!is_leaflist_item(node)) {
+        return 0;
+    }
+    if (!key || key->type != XML_TEXT_NODE || !key->content) {
+        return -1;
+    }
+
+    value = strtrim((char *) key->content, &len);
+    if (len == 0 || len >= EQUIV_KEY_MAX) {
+        /* blank values are compared by the linear scan */
+        return -1;
+    }
+    memcpy(buf, value, len);
+    buf[len] = '\0';
+
+    return 1;
+}
+
+/* Get the string identifying the parent in the index */
+static const xmlChar *
+equiv_index_parent_id(xmlNodePtr parent, char *buf, size_t size)
+{
+    snprintf(buf, size, "%p", (void *) parent);
+    return BAD_CAST buf;
+}
+
+/*
+ * Add the node into the index of its parent. If it cannot be identified by
+ * the index, the parent falls back to the linear scan.
+ */
+static void
+equiv_index_add(xmlNodePtr node)
+{
+    char key[EQUIV_KEY_MAX], id[32];
+    xmlNodePtr parent = node->parent;
+    void *state;
+    int r;
+
+    if (!parent || node->doc != equiv_index.doc || !equiv_index.parents) {
+        return;
+    }
+    equiv_index_parent_id(parent, id, sizeof id);
+    state = xmlHashLookup(equiv_index.parents, BAD_CAST id);
+    if (state != parent) {
+        /* not indexed or already scanned linearly */
+        return;
+    }
+
+    r = equiv_index_key(node, key);
+    if (r < 0 || (r > 0 && xmlHashAddEntry3(equiv_index.nodes, node->name,
+                                            BAD_CAST key, BAD_CAST id,
+                                            node) != 0)) {
+        /* unidentifiable or duplicated instance */
+        xmlHashUpdateEntry(equiv_index.parents, BAD_CAST id, EQUIV_LINEAR,
+                           NULL);
+    }
+}
+
+/* Remove the node and its subtree from the index */
+static void
+equiv_index_remove(xmlNodePtr node)
+{
+    char key[EQUIV_KEY_MAX], id[32];
+    xmlNodePtr child;
+
+    if (node->doc != equiv_index.doc || !equiv_index.parents
+        || node->type != XML_ELEMENT_NODE) {
+        return;
+    }
+
+    if (node->parent && equiv_index_key(node, key) > 0) {
+        equiv_index_parent_id(node->parent, id, sizeof id);
+        if (xmlHashLookup3(equiv_index.nodes, node->name, BAD_CAST key,
+                           BAD_CAST id) == node) {
+            xmlHashRemoveEntry3(equiv_index.nodes, node->name, BAD_CAST key,
+                                BAD_CAST id, NULL);
+        }
+    }
+
+    equiv_index_parent_id(node, id, sizeof id);
+    xmlHashRemoveEntry(equiv_index.parents, BAD_CAST id, NULL);
+    for (child = node->children; child; child = child->next) {
+        equiv_index_remove(child);
+    }
+}
+
+/*
+ * Look the equivalent of the edit node up among the children of orig_parent.
+ *
+ * @param[in] orig_parent Parent of the equivalent in the original document.
+ * @param[in] edit Element from the edit-config data.
+ * @param[out] equiv Found equivalent, NULL if there is no such element.
+ * @return 1 if the index was used, 0 if the children must be scanned
+ * linearly.
+ */
+static int
+equiv_index_find(xmlNodePtr orig_parent, xmlNodePtr edit, xmlNodePtr *equiv)
+{
+    char key[EQUIV_KEY_MAX], id[32];
+    xmlNodePtr child, node;
+    void *state;
+
+    if (equiv_index_key(edit, key) <= 0) {
+        return 0;
+    }
+
+    if (equiv_index.doc != orig_parent->doc) {
+        equiv_index_reset();
+        equiv_index.doc = orig_parent->doc;
+    }
+    if (!equiv_index.parents) {
+        equiv_index.nodes = xmlHashCreate(0);
+        equiv_index.parents = xmlHashCreate(0);
+        if (!equiv_index.nodes || !equiv_index.parents) {
+            nc_verb_error("Memory allocation failed (%s).", __func__);
+            equiv_index_reset();
+            return 0;
+        }
+    }
+
+    equiv_index_parent_id(orig_parent, id, sizeof id);
+    state = xmlHashLookup(equiv_index.parents, BAD_CAST id);
+    if (!state) {
+        xmlHashAddEntry(equiv_index.parents, BAD_CAST id, orig_parent);
+        for (child = orig_parent->children; child; child = child->next) {
+            equiv_index_add(child);
+        }
+        state = xmlHashLookup(equiv_index.parents, BAD_CAST id);
+    }
+    if (state != orig_parent) {
+        return 0;
+    }
+
+    node = xmlHashLookup3(equiv_index.nodes, edit->name, BAD_CAST key,
+                          BAD_CAST id);
+    if (node && matching_elements(edit, node) != 1) {
+        /* e.g. different namespace, let the linear scan decide */
+        return 0;
+    }
+    *equiv = node;
+
+    return 1;
+}
+
 /**
  * \brief Find an equivalent of the given edit node in the orig_doc document.
  *
@@ -530,6 +844,11 @@ find_element_equiv(xmlDocPtr orig_doc, xmlNodePtr edit)
         return (NULL);
     }
 
+    /* list instances are looked up in the index */
+    if (equiv_index_find(orig_parent, edit, &node)) {
+        return (node);
+    }
+
     /* element check */
     node = orig_parent->children;
     while (node != NULL) {
@@ -734,39 +1053,32 @@ check_edit_ops_hierarchy(xmlNodePtr edit, NC_EDIT_DEFOP_TYPE defop,
  * operation types are valid).
  * \param[in] defop Default edit-config's operation for this edit-config call.
  * \param[in] orig Original configuration document to edit.
- * \param[in] edit XML document covering edit-config's \<config\> element
- * supposed to edit the orig configuration data.
+ * \param[in] ops Elements with an explicit operation in the edit document
+ * supposed to edit the orig configuration data, see collect_edit_ops().
  * \param[out] err NETCONF error structure.
  * \return On error, non-zero is returned and an err structure is filled.
  * 0 is returned on success.
  */
-int
+static int
 check_edit_ops(NC_EDIT_OP_TYPE op, NC_EDIT_DEFOP_TYPE defop, xmlDocPtr orig,
-               xmlDocPtr edit, struct nc_err **error)
+               struct edit_ops *ops, struct nc_err **error)
 {
-    xmlXPathObjectPtr operation_nodes = NULL;
     xmlNodePtr node_to_process = NULL, n;
     xmlChar *defval = NULL, *value = NULL;
-    int i, r;
+    int i, r, phase;
 
-    operation_nodes = get_operation_elements(op, edit);
-    if (operation_nodes == NULL) {
+    phase = get_phase_index(op);
+    if (phase < 0) {
+        nc_verb_error("Unsupported edit operation %d (%s)", op, __func__);
         *error = nc_err_new(NC_ERR_OP_FAILED);
         return EXIT_FAILURE;
     }
-
-    if (xmlXPathNodeSetIsEmpty(operation_nodes->nodesetval)) {
-        xmlXPathFreeObject(operation_nodes);
-        return EXIT_SUCCESS;
-    }
-
     *error = NULL;
-    for (i = 0; i < operation_nodes->nodesetval->nodeNr; i++) {
-        node_to_process = operation_nodes->nodesetval->nodeTab[i];
+    for (i = 0; i < ops->n[phase]; i++) {
+        node_to_process = ops->nodes[phase][i].node;
 
         r = check_edit_ops_hierarchy(node_to_process, defop, error);
         if (r != EXIT_SUCCESS) {
-            xmlXPathFreeObject(operation_nodes);
             return EXIT_FAILURE;
         }
 
@@ -796,6 +1108,8 @@ check_edit_ops(NC_EDIT_OP_TYPE op, NC_EDIT_DEFOP_TYPE defop, xmlDocPtr orig,
                 } else {
                     /* remove delete operation - it is valid but there is no
                      * reason to really perform it */
+                    edit_ops_remove(ops, node_to_process);
+                    i--;
                     xmlUnlinkNode(node_to_process);
                     xmlFreeNode(node_to_process);
                 }
@@ -829,6 +1143,7 @@ check_edit_ops(NC_EDIT_OP_TYPE op, NC_EDIT_DEFOP_TYPE defop, xmlDocPtr orig,
                 } else {
                     /* remove old node in configuration to allow recreate it
                      * by the new one with the default value */
+                    equiv_index_remove(n);
                     xmlUnlinkNode(n);
                     xmlFreeNode(n);
                 }
@@ -843,7 +1158,6 @@ check_edit_ops(NC_EDIT_OP_TYPE op, NC_EDIT_DEFOP_TYPE defop, xmlDocPtr orig,
             }
         }
     }
-    xmlXPathFreeObject(operation_nodes);
     if (defval != NULL) {
         xmlFree(defval);
     }
@@ -917,7 +1231,7 @@ compact_edit_operations_r(xmlNodePtr node, NC_EDIT_OP_TYPE supreme_op)
  *
  * @return EXIT_SUCCESS or EXIT_FAILURE
  */
-int
+static int
 compact_edit_operations(xmlDocPtr edit_doc, NC_EDIT_DEFOP_TYPE defop)
 {
     xmlNodePtr root;
@@ -944,6 +1258,10 @@ compact_edit_operations(xmlDocPtr edit_doc, NC_EDIT_DEFOP_TYPE defop)
 /**
  * \brief Perform all the edit-config's operations specified in the edit_doc.
  *
+ * The elements with an explicit operation are found in a single walk of the
+ * edit_doc, the operation rules are checked by check_edit_ops() before
+ * anything is changed and the operations are compacted.
+ *
  * \param[in] orig_doc Original configuration document to edit.
  * \param[in] edit_doc XML document covering edit-config's \<config\> element
  *                     supposed to edit orig_doc configuration data.
@@ -957,9 +1275,9 @@ int
 edit_operations(xmlDocPtr orig_doc, xmlDocPtr edit_doc,
                 NC_EDIT_DEFOP_TYPE defop, int running, struct nc_err **error)
 {
-    xmlXPathObjectPtr nodes;
-    int i;
-    xmlNodePtr orig_node, edit_node;
+    struct edit_ops ops;
+    int i, phase, logged;
+    xmlNodePtr edit_node;
 
     *error = NULL;
 
@@ -967,6 +1285,22 @@ edit_operations(xmlDocPtr orig_doc, xmlDocPtr edit_doc,
         nc_verb_error("No data to edit");
         return EXIT_FAILURE;
     }
+    equiv_index_reset();
+
+    if (collect_edit_ops(edit_doc, &ops) != EXIT_SUCCESS) {
+        goto error;
+    }
+
+    /* check operations */
+    if (check_edit_ops(NC_EDIT_OP_DELETE, defop, orig_doc, &ops, error)
+        || check_edit_ops(NC_EDIT_OP_CREATE, defop, orig_doc, &ops, error)) {
+        goto error;
+    }
+
+    if (compact_edit_operations(edit_doc, defop) != EXIT_SUCCESS) {
+        nc_verb_error("Compacting edit-config operations failed.");
+        goto error;
+    }
 
     /* default replace */
     if (defop == NC_EDIT_DEFOP_REPLACE) {
@@ -978,109 +1312,27 @@ edit_operations(xmlDocPtr orig_doc, xmlDocPtr edit_doc,
         }
     }
 
-    /* delete operations */
-    nodes = get_operation_elements(NC_EDIT_OP_DELETE, edit_doc);
-    if (nodes != NULL) {
-        if (!xmlXPathNodeSetIsEmpty(nodes->nodesetval)) {
-            /* something to delete */
-            nc_verb_verbose("edit-config: delete");
-            for (i = 0; i < nodes->nodesetval->nodeNr; i++) {
-                edit_node = nodes->nodesetval->nodeTab[i];
-                orig_node = find_element_equiv(orig_doc, edit_node);
-                if (orig_node == NULL) {
-                    xmlXPathFreeObject(nodes);
-                    if (error != NULL) {
-                        *error = nc_err_new(NC_ERR_DATA_MISSING);
-                    }
-                    goto error;
-                }
-                for (; orig_node != NULL;
-                     orig_node = find_element_equiv(orig_doc, edit_node)) {
-                    /* remove the edit node's equivalent from the original
-                     * document */
-                    if (edit_delete(orig_node, running, 1, error)) {
-                        xmlXPathFreeObject(nodes);
-                        goto error;
-                    }
-                }
-                /* remove the node from the edit document */
-                edit_delete(edit_node, 0, 0, error);
-                nodes->nodesetval->nodeTab[i] = NULL;
+    /* explicit operations applied phase by phase; the default replace
+     * consumed the whole edit_doc */
+    for (phase = 0; defop != NC_EDIT_DEFOP_REPLACE && phase < EDIT_N_PHASES;
+         phase++) {
+        logged = 0;
+        for (i = 0; i < ops.n[phase]; i++) {
+            edit_node = ops.nodes[phase][i].node;
+            if (ops.nodes[phase][i].nested
+                || get_operation_phase(edit_node) != phase) {
+                /* consumed by its ancestor or the operation was compacted */
+                continue;
             }
-        }
-        xmlXPathFreeObject(nodes);
-    }
-
-    /* remove operations */
-    nodes = get_operation_elements(NC_EDIT_OP_REMOVE, edit_doc);
-    if (nodes != NULL) {
-        if (!xmlXPathNodeSetIsEmpty(nodes->nodesetval)) {
-            /* something to remove */
-            nc_verb_verbose("edit-config: remove");
-            for (i = 0; i < nodes->nodesetval->nodeNr; i++) {
-                if (edit_remove(orig_doc, nodes->nodesetval->nodeTab[i],
-                                running, error) != EXIT_SUCCESS) {
-                    xmlXPathFreeObject(nodes);
-                    goto error;
-                }
-                nodes->nodesetval->nodeTab[i] = NULL;
+            if (!logged) {
+                nc_verb_verbose("edit-config: %s", edit_phases[phase].log);
+                logged = 1;
             }
-        }
-        xmlXPathFreeObject(nodes);
-    }
-
-    /* replace operations */
-    nodes = get_operation_elements(NC_EDIT_OP_REPLACE, edit_doc);
-    if (nodes != NULL) {
-        if (!xmlXPathNodeSetIsEmpty(nodes->nodesetval)) {
-            /* something to replace */
-            nc_verb_verbose("edit-config: replace");
-            for (i = 0; i < nodes->nodesetval->nodeNr; i++) {
-                if (edit_replace(orig_doc, nodes->nodesetval->nodeTab[i],
-                                 running, error) != EXIT_SUCCESS) {
-                    xmlXPathFreeObject(nodes);
-                    goto error;
-                }
-                nodes->nodesetval->nodeTab[i] = NULL;
+            if (edit_phases[phase].apply(orig_doc, edit_node,
+                                         running, error) != EXIT_SUCCESS) {
+                goto error;
             }
         }
-        xmlXPathFreeObject(nodes);
-    }
-
-    /* create operations */
-    nodes = get_operation_elements(NC_EDIT_OP_CREATE, edit_doc);
-    if (nodes != NULL) {
-        if (!xmlXPathNodeSetIsEmpty(nodes->nodesetval)) {
-            /* something to create */
-            nc_verb_verbose("edit-config: create");
-            for (i = 0; i < nodes->nodesetval->nodeNr; i++) {
-                if (edit_create(orig_doc, nodes->nodesetval->nodeTab[i],
-                                running, error) != EXIT_SUCCESS) {
-                    xmlXPathFreeObject(nodes);
-                    goto error;
-                }
-                nodes->nodesetval->nodeTab[i] = NULL;
-            }
-        }
-        xmlXPathFreeObject(nodes);
-    }
-
-    /* merge operations */
-    nodes = get_operation_elements(NC_EDIT_OP_MERGE, edit_doc);
-    if (nodes != NULL) {
-        if (!xmlXPathNodeSetIsEmpty(nodes->nodesetval)) {
-            /* something to create */
-            nc_verb_verbose("edit-config: explicit merge");
-            for (i = 0; i < nodes->nodesetval->nodeNr; i++) {
-                if (edit_merge(orig_doc, nodes->nodesetval->nodeTab[i],
-                               running, error) != EXIT_SUCCESS) {
-                    xmlXPathFreeObject(nodes);
-                    goto error;
-                }
-                nodes->nodesetval->nodeTab[i] = NULL;
-            }
-        }
-        xmlXPathFreeObject(nodes);
     }
 
     /* default merge */
@@ -1097,10 +1349,14 @@ edit_operations(xmlDocPtr orig_doc, xmlDocPtr edit_doc,
             }
         }
     }
+    edit_ops_destroy(&ops);
+    equiv_index_reset();
 
     return EXIT_SUCCESS;
 
 error:
+    edit_ops_destroy(&ops);
+    equiv_index_reset();
 
     if (*error == NULL) {
         *error = nc_err_new(NC_ERR_OP_FAILED);
@@ -1109,6 +1365,505 @@ error:
     return EXIT_FAILURE;
 }
 
+/* how the OVSDB handler of a schema node is called */
+enum edit_call {
+    EDIT_CALL_IGNORE,           /* nothing to apply, only the checks */
+    EDIT_CALL_CHILDREN,         /* apply the operation on the children */
+    EDIT_CALL_VOID,             /* fn(e) */
+    EDIT_CALL_NODE,             /* fn(node, e) */
+    EDIT_CALL_KEY,              /* fn(key, e) */
+    EDIT_CALL_KEY_VALUE,        /* fn(key, value, e) */
+    EDIT_CALL_KEY_NODE,         /* fn(key, node, e) */
+    EDIT_CALL_KEY_NAME_VALUE,   /* fn(key, name, value, e) */
+    EDIT_CALL_KEY_NAME_NODE,    /* fn(key, name, node, e) */
+    EDIT_CALL_KEY_CHILDREN      /* fn(key, child, e) for each child */
+};
+
+/* pass NULL instead of the node or its value, i.e. reset the item */
+#define EDIT_F_CLEAR       0x01
+/* the node must have a value (leafref) */
+#define EDIT_F_LEAFREF     0x02
+/* the key must be present in the node */
+#define EDIT_F_KEY_REQUIRED 0x04
+
+/*
+ * OVSDB handler of the (schema path, operation) pair. The key passed to the
+ * handler is the value of the key_name child of the key_level-th ancestor
+ * of the node (0 is the node itself). The last component of the path can be
+ * "*" to match any child of the parent without its own entry.
+ */
+struct edit_handler {
+    const char *path;
+    NC_EDIT_OP_TYPE op;
+    enum edit_call call;
+    int key_level;
+    const char *key_name;
+    unsigned int flags;
+    union {
+        int (*fn_void)(struct nc_err **);
+        int (*node)(xmlNodePtr, struct nc_err **);
+        int (*key)(const xmlChar *, struct nc_err **);
+        int (*key_value)(const xmlChar *, const xmlChar *, struct nc_err **);
+        int (*key_node)(const xmlChar *, xmlNodePtr, struct nc_err **);
+        int (*key_name_value)(const xmlChar *, const xmlChar *,
+                              const xmlChar *, struct nc_err **);
+        int (*key_name_node)(const xmlChar *, const char *, xmlNodePtr,
+                             struct nc_err **);
+    } fn;
+};
+
+static int
+ovs_set_switchid(xmlNodePtr node, struct nc_err **e)
+{
+    ofc_set_switchid(node);
+    return EXIT_SUCCESS;
+}
+
+static int
+ovs_add_contr(xmlNodePtr node, struct nc_err **e)
+{
+    return txn_add_contr(node, get_key(node->parent->parent, "id"), e);
+}
+
+static int
+ovs_del_contr(xmlNodePtr node, struct nc_err **e)
+{
+    return txn_del_contr(get_key(node, "id"),
+                         get_key(node->parent->parent, "id"), e);
+}
+
+/*
+ * Reference to the queue from the logical switch is only informative, so
+ * inform client that some other change is expected. But first, check that
+ * such a change was not performed.
+ */
+static int
+ovs_check_bridge_queue(xmlNodePtr node, struct nc_err **e)
+{
+    switch (ofc_check_bridge_queue(get_key(node->parent->parent, "id"),
+                                   node->children->content)) {
+    case 1:
+        *e = nc_err_new(NC_ERR_BAD_ELEM);
+        nc_err_set(*e, NC_ERR_PARAM_INFO_BADELEM, "queue");
+        nc_err_set(*e, NC_ERR_PARAM_MSG, "Invalid queue leafref");
+        return EXIT_FAILURE;
+    case 2:
+        *e = nc_err_new(NC_ERR_OP_FAILED);
+        nc_err_set(*e, NC_ERR_PARAM_MSG,
+                   "Assigning queue to the bridge (port) must "
+                   "be done by the port element in the queue");
+        return EXIT_FAILURE;
+    default:
+        /* everything was done elsewhere, so we are done */
+        return EXIT_SUCCESS;
+    }
+}
+
+#define CS "capable-switch"
+#define CS_RES CS "/resources"
+#define CS_PORT CS_RES "/port"
+#define CS_QUEUE CS_RES "/queue"
+#define CS_OWNCERT CS_RES "/owned-certificate"
+#define CS_EXTCERT CS_RES "/external-certificate"
+#define CS_TABLE CS_RES "/flow-table"
+#define CS_SWITCH CS "/logical-switches/switch"
+#define CS_CONTR CS_SWITCH "/controllers/controller"
+#define CS_SWRES CS_SWITCH "/resources"
+
+#define OP_C NC_EDIT_OP_CREATE
+#define OP_D NC_EDIT_OP_DELETE
+
+/*
+ * Mapping of the configuration data to the OVSDB changes. Elements without
+ * an entry are reported as unknown, elements which are intentionally not
+ * applied have EDIT_CALL_IGNORE.
+ */
+static const struct edit_handler edit_handlers[] = {
+    {CS, OP_C, EDIT_CALL_CHILDREN, 0, "id", EDIT_F_KEY_REQUIRED, {NULL}},
+    {CS, OP_D, EDIT_CALL_VOID, 0, NULL, 0, {.fn_void = txn_del_all}},
+    {CS "/id", OP_C, EDIT_CALL_NODE, 0, NULL, 0,
+     {.node = ovs_set_switchid}},
+    {CS "/id", OP_D, EDIT_CALL_NODE, 0, NULL, EDIT_F_CLEAR,
+     {.node = ovs_set_switchid}},
+    {CS_RES, OP_C, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_RES, OP_D, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS "/logical-switches", OP_C, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS "/logical-switches", OP_D, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+
+    /* port */
+    {CS_PORT, OP_C, EDIT_CALL_NODE, 0, NULL, 0, {.node = txn_add_port}},
+    {CS_PORT, OP_D, EDIT_CALL_KEY, 0, "name", 0, {.key = txn_del_port}},
+    {CS_PORT "/requested-number", OP_C, EDIT_CALL_KEY_VALUE, 1, "name", 0,
+     {.key_value = txn_mod_port_reqnumber}},
+    {CS_PORT "/requested-number", OP_D, EDIT_CALL_KEY_VALUE, 1, "name",
+     EDIT_F_CLEAR, {.key_value = txn_mod_port_reqnumber}},
+    {CS_PORT "/configuration", OP_C, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_PORT "/configuration", OP_D, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    /* no-receive, no-forward, no-packet-in, admin-state */
+    {CS_PORT "/configuration/*", OP_C, EDIT_CALL_KEY_NAME_VALUE, 2, "name", 0,
+     {.key_name_value = of_mod_port_cfg}},
+    /* delete -> set to default */
+    {CS_PORT "/configuration/*", OP_D, EDIT_CALL_KEY_NAME_VALUE, 2, "name",
+     EDIT_F_CLEAR, {.key_name_value = of_mod_port_cfg}},
+    {CS_PORT "/features", OP_C, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_PORT "/features", OP_D, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_PORT "/features/advertised", OP_C, EDIT_CALL_KEY_CHILDREN, 2, "name",
+     0, {.key_node = txn_add_port_advert}},
+    {CS_PORT "/features/advertised", OP_D, EDIT_CALL_KEY_CHILDREN, 2, "name",
+     0, {.key_node = txn_del_port_advert}},
+    {CS_PORT "/features/advertised/*", OP_C, EDIT_CALL_KEY_NODE, 3, "name",
+     0, {.key_node = txn_add_port_advert}},
+    {CS_PORT "/features/advertised/*", OP_D, EDIT_CALL_KEY_NODE, 3, "name",
+     0, {.key_node = txn_del_port_advert}},
+    /* TODO: remove previous branch of choice on create */
+    {CS_PORT "/ipgre-tunnel", OP_C, EDIT_CALL_KEY_NODE, 1, "name", 0,
+     {.key_node = txn_add_port_tunnel}},
+    {CS_PORT "/ipgre-tunnel", OP_D, EDIT_CALL_KEY_NODE, 1, "name", 0,
+     {.key_node = txn_del_port_tunnel}},
+    {CS_PORT "/ipgre-tunnel/*", OP_C, EDIT_CALL_KEY_NAME_VALUE, 2, "name", 0,
+     {.key_name_value = txn_mod_port_tunnel_opt}},
+    {CS_PORT "/ipgre-tunnel/*", OP_D, EDIT_CALL_KEY_NAME_VALUE, 2, "name",
+     EDIT_F_CLEAR, {.key_name_value = txn_mod_port_tunnel_opt}},
+    {CS_PORT "/vxlan-tunnel", OP_C, EDIT_CALL_KEY_NODE, 1, "name", 0,
+     {.key_node = txn_add_port_tunnel}},
+    {CS_PORT "/vxlan-tunnel", OP_D, EDIT_CALL_KEY_NODE, 1, "name", 0,
+     {.key_node = txn_del_port_tunnel}},
+    {CS_PORT "/vxlan-tunnel/*", OP_C, EDIT_CALL_KEY_NAME_VALUE, 2, "name", 0,
+     {.key_name_value = txn_mod_port_tunnel_opt}},
+    {CS_PORT "/vxlan-tunnel/*", OP_D, EDIT_CALL_KEY_NAME_VALUE, 2, "name",
+     EDIT_F_CLEAR, {.key_name_value = txn_mod_port_tunnel_opt}},
+    {CS_PORT "/tunnel", OP_C, EDIT_CALL_KEY_NODE, 1, "name", 0,
+     {.key_node = txn_add_port_tunnel}},
+    {CS_PORT "/tunnel", OP_D, EDIT_CALL_KEY_NODE, 1, "name", 0,
+     {.key_node = txn_del_port_tunnel}},
+    {CS_PORT "/tunnel/*", OP_C, EDIT_CALL_KEY_NAME_VALUE, 2, "name", 0,
+     {.key_name_value = txn_mod_port_tunnel_opt}},
+    {CS_PORT "/tunnel/*", OP_D, EDIT_CALL_KEY_NAME_VALUE, 2, "name",
+     EDIT_F_CLEAR, {.key_name_value = txn_mod_port_tunnel_opt}},
+
+    /* queue */
+    {CS_QUEUE, OP_C, EDIT_CALL_NODE, 0, NULL, 0, {.node = txn_add_queue}},
+    {CS_QUEUE, OP_D, EDIT_CALL_KEY, 0, "resource-id", 0,
+     {.key = txn_del_queue}},
+    /* id is not the key -> it can be changed */
+    {CS_QUEUE "/id", OP_C, EDIT_CALL_KEY_VALUE, 1, "resource-id", 0,
+     {.key_value = txn_mod_queue_id}},
+    /* id is mandatory, the subsequent create of the replace operation allows
+     * to replace the current value directly */
+    {CS_QUEUE "/id", OP_D, EDIT_CALL_IGNORE, 0, NULL, 0, {NULL}},
+    {CS_QUEUE "/port", OP_C, EDIT_CALL_KEY_VALUE, 1, "resource-id", 0,
+     {.key_value = txn_add_queue_port}},
+    {CS_QUEUE "/port", OP_D, EDIT_CALL_KEY, 1, "resource-id", 0,
+     {.key = txn_del_queue_port}},
+    {CS_QUEUE "/properties", OP_C, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_QUEUE "/properties", OP_D, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_QUEUE "/properties/*", OP_C, EDIT_CALL_KEY_NAME_NODE, 2,
+     "resource-id", 0, {.key_name_node = txn_mod_queue_options}},
+    {CS_QUEUE "/properties/*", OP_D, EDIT_CALL_KEY_NAME_NODE, 2,
+     "resource-id", EDIT_F_CLEAR, {.key_name_node = txn_mod_queue_options}},
+
+    /* certificates */
+    {CS_OWNCERT, OP_C, EDIT_CALL_NODE, 0, NULL, 0,
+     {.node = txn_add_owned_certificate}},
+    {CS_OWNCERT, OP_D, EDIT_CALL_NODE, 0, NULL, 0,
+     {.node = txn_del_owned_certificate}},
+    {CS_OWNCERT "/*", OP_C, EDIT_CALL_KEY_NODE, 1, "resource-id", 0,
+     {.key_node = txn_mod_own_cert_certificate}},
+    {CS_OWNCERT "/*", OP_D, EDIT_CALL_KEY_NODE, 1, "resource-id",
+     EDIT_F_CLEAR, {.key_node = txn_mod_own_cert_certificate}},
+    {CS_OWNCERT "/private-key", OP_C, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_OWNCERT "/private-key", OP_D, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_OWNCERT "/private-key/key-type", OP_C, EDIT_CALL_KEY_NODE, 2,
+     "resource-id", 0, {.key_node = txn_mod_own_cert_key_type}},
+    {CS_OWNCERT "/private-key/key-type", OP_D, EDIT_CALL_KEY_NODE, 2,
+     "resource-id", EDIT_F_CLEAR, {.key_node = txn_mod_own_cert_key_type}},
+    {CS_OWNCERT "/private-key/key-data", OP_C, EDIT_CALL_KEY_NODE, 2,
+     "resource-id", 0, {.key_node = txn_mod_own_cert_key_data}},
+    {CS_OWNCERT "/private-key/key-data", OP_D, EDIT_CALL_KEY_NODE, 2,
+     "resource-id", EDIT_F_CLEAR, {.key_node = txn_mod_own_cert_key_data}},
+    {CS_EXTCERT, OP_C, EDIT_CALL_NODE, 0, NULL, 0,
+     {.node = txn_add_external_certificate}},
+    {CS_EXTCERT, OP_D, EDIT_CALL_NODE, 0, NULL, 0,
+     {.node = txn_del_external_certificate}},
+    {CS_EXTCERT "/*", OP_C, EDIT_CALL_KEY_NODE, 1, "resource-id", 0,
+     {.key_node = txn_mod_ext_cert_certificate}},
+    {CS_EXTCERT "/*", OP_D, EDIT_CALL_KEY_NODE, 1, "resource-id",
+     EDIT_F_CLEAR, {.key_node = txn_mod_ext_cert_certificate}},
+
+    /* flow-table, key 'table-id' cannot be changed */
+    {CS_TABLE, OP_C, EDIT_CALL_NODE, 0, NULL, 0,
+     {.node = txn_add_flow_table}},
+    {CS_TABLE, OP_D, EDIT_CALL_KEY, 0, "table-id", 0,
+     {.key = txn_del_flow_table}},
+    {CS_TABLE "/name", OP_C, EDIT_CALL_KEY_NODE, 1, "table-id", 0,
+     {.key_node = txn_mod_flowtable_name}},
+    {CS_TABLE "/name", OP_D, EDIT_CALL_KEY_NODE, 1, "table-id", EDIT_F_CLEAR,
+     {.key_node = txn_mod_flowtable_name}},
+    {CS_TABLE "/resource-id", OP_C, EDIT_CALL_KEY_NODE, 1, "table-id", 0,
+     {.key_node = txn_mod_flowtable_resid}},
+    {CS_TABLE "/resource-id", OP_D, EDIT_CALL_KEY_NODE, 1, "table-id",
+     EDIT_F_CLEAR, {.key_node = txn_mod_flowtable_resid}},
+
+    /* logical switch, key 'id' cannot be changed */
+    {CS_SWITCH, OP_C, EDIT_CALL_NODE, 0, NULL, 0, {.node = txn_add_bridge}},
+    {CS_SWITCH, OP_D, EDIT_CALL_KEY, 0, "id", 0, {.key = txn_del_bridge}},
+    {CS_SWITCH "/datapath-id", OP_C, EDIT_CALL_KEY_VALUE, 1, "id", 0,
+     {.key_value = txn_mod_bridge_datapath}},
+    {CS_SWITCH "/datapath-id", OP_D, EDIT_CALL_KEY_VALUE, 1, "id",
+     EDIT_F_CLEAR, {.key_value = txn_mod_bridge_datapath}},
+    {CS_SWITCH "/lost-connection-behavior", OP_C, EDIT_CALL_KEY_VALUE, 1,
+     "id", 0, {.key_value = txn_mod_bridge_failmode}},
+    {CS_SWITCH "/lost-connection-behavior", OP_D, EDIT_CALL_KEY_VALUE, 1,
+     "id", EDIT_F_CLEAR, {.key_value = txn_mod_bridge_failmode}},
+    /* enabled is not handled: it is too complicated to handle it in
+     * combination with the OVSDB's garbage collection. */
+    {CS_SWITCH "/enabled", OP_C, EDIT_CALL_IGNORE, 0, NULL, 0, {NULL}},
+    {CS_SWITCH "/enabled", OP_D, EDIT_CALL_IGNORE, 0, NULL, 0, {NULL}},
+    {CS_SWITCH "/check-controller-certificate", OP_C, EDIT_CALL_IGNORE, 0,
+     NULL, 0, {NULL}},
+    {CS_SWITCH "/check-controller-certificate", OP_D, EDIT_CALL_IGNORE, 0,
+     NULL, 0, {NULL}},
+    {CS_SWITCH "/controllers", OP_C, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_SWITCH "/controllers", OP_D, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_CONTR, OP_C, EDIT_CALL_NODE, 0, NULL, 0, {.node = ovs_add_contr}},
+    {CS_CONTR, OP_D, EDIT_CALL_NODE, 0, NULL, 0, {.node = ovs_del_contr}},
+    {CS_CONTR "/local-ip-address", OP_C, EDIT_CALL_KEY_VALUE, 1, "id", 0,
+     {.key_value = txn_mod_contr_lip}},
+    {CS_CONTR "/local-ip-address", OP_D, EDIT_CALL_KEY_VALUE, 1, "id",
+     EDIT_F_CLEAR, {.key_value = txn_mod_contr_lip}},
+    {CS_CONTR "/ip-address", OP_C, EDIT_CALL_KEY_NAME_VALUE, 1, "id", 0,
+     {.key_name_value = txn_mod_contr_target}},
+    {CS_CONTR "/ip-address", OP_D, EDIT_CALL_KEY_NAME_VALUE, 1, "id",
+     EDIT_F_CLEAR, {.key_name_value = txn_mod_contr_target}},
+    {CS_CONTR "/port", OP_C, EDIT_CALL_KEY_NAME_VALUE, 1, "id", 0,
+     {.key_name_value = txn_mod_contr_target}},
+    {CS_CONTR "/port", OP_D, EDIT_CALL_KEY_NAME_VALUE, 1, "id",
+     EDIT_F_CLEAR, {.key_name_value = txn_mod_contr_target}},
+    {CS_CONTR "/protocol", OP_C, EDIT_CALL_KEY_NAME_VALUE, 1, "id", 0,
+     {.key_name_value = txn_mod_contr_target}},
+    {CS_CONTR "/protocol", OP_D, EDIT_CALL_KEY_NAME_VALUE, 1, "id",
+     EDIT_F_CLEAR, {.key_name_value = txn_mod_contr_target}},
+    {CS_SWRES, OP_C, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_SWRES, OP_D, EDIT_CALL_CHILDREN, 0, NULL, 0, {NULL}},
+    {CS_SWRES "/port", OP_C, EDIT_CALL_KEY_VALUE, 2, "id", EDIT_F_LEAFREF,
+     {.key_value = txn_add_bridge_port}},
+    {CS_SWRES "/port", OP_D, EDIT_CALL_KEY_VALUE, 2, "id", EDIT_F_LEAFREF,
+     {.key_value = txn_del_bridge_port}},
+    {CS_SWRES "/flow-table", OP_C, EDIT_CALL_KEY_VALUE, 2, "id",
+     EDIT_F_LEAFREF, {.key_value = txn_add_bridge_flowtable}},
+    {CS_SWRES "/flow-table", OP_D, EDIT_CALL_KEY_VALUE, 2, "id",
+     EDIT_F_LEAFREF, {.key_value = txn_del_bridge_flowtable}},
+    {CS_SWRES "/queue", OP_C, EDIT_CALL_NODE, 0, NULL, EDIT_F_LEAFREF,
+     {.node = ovs_check_bridge_queue}},
+    /* queue is linked with the port, reference here is only informative */
+    {CS_SWRES "/queue", OP_D, EDIT_CALL_IGNORE, 0, NULL, EDIT_F_LEAFREF,
+     {NULL}},
+    /* certificate is ignored on purpose! Once defined, it is automatically
+     * referenced and used in every bridge. */
+    {CS_SWRES "/certificate", OP_C, EDIT_CALL_IGNORE, 0, NULL,
+     EDIT_F_LEAFREF, {NULL}},
+    {CS_SWRES "/certificate", OP_D, EDIT_CALL_IGNORE, 0, NULL,
+     EDIT_F_LEAFREF, {NULL}},
+};
+
+#undef CS
+#undef CS_RES
+#undef CS_PORT
+#undef CS_QUEUE
+#undef CS_OWNCERT
+#undef CS_EXTCERT
+#undef CS_TABLE
+#undef CS_SWITCH
+#undef CS_CONTR
+#undef CS_SWRES
+#undef OP_C
+#undef OP_D
+
+#define EDIT_N_HANDLERS \
+    ((int) (sizeof edit_handlers / sizeof edit_handlers[0]))
+
+/* edit_handlers indexed by the schema path and the operation */
+static xmlHashTablePtr edit_handlers_index;
+
+/* maximal depth and length of the schema path of the configuration data */
+#define EDIT_DEPTH_MAX 16
+#define EDIT_PATH_MAX 256
+
+static const char *
+edit_op_name(NC_EDIT_OP_TYPE op)
+{
+    return (op == NC_EDIT_OP_CREATE ? "create" : "delete");
+}
+
+static void
+edit_handlers_destroy(void)
+{
+    xmlHashFree(edit_handlers_index, NULL);
+    edit_handlers_index = NULL;
+}
+
+/*
+ * Get the handler of the operation on the node.
+ *
+ * @param[in] node XML element from the configuration data
+ * @param[in] op NC_EDIT_OP_CREATE or NC_EDIT_OP_DELETE
+ * @return found handler, NULL if the node is unknown.
+ */
+static const struct edit_handler *
+edit_handler_find(xmlNodePtr node, NC_EDIT_OP_TYPE op)
+{
+    const struct edit_handler *h;
+    xmlNodePtr nodes[EDIT_DEPTH_MAX];
+    char path[EDIT_PATH_MAX];
+    size_t len, last = 0;
+    int i, depth = 0;
+
+    if (!edit_handlers_index) {
+        edit_handlers_index = xmlHashCreate(2 * EDIT_N_HANDLERS);
+        if (!edit_handlers_index) {
+            nc_verb_error("Memory allocation failed (%s).", __func__);
+            return NULL;
+        }
+        for (i = 0; i < EDIT_N_HANDLERS; i++) {
+            xmlHashAddEntry2(edit_handlers_index,
+                             BAD_CAST edit_handlers[i].path,
+                             BAD_CAST edit_op_name(edit_handlers[i].op),
+                             (void *) &edit_handlers[i]);
+        }
+    }
+
+    for (; node && node->type == XML_ELEMENT_NODE; node = node->parent) {
+        if (depth == EDIT_DEPTH_MAX) {
+            return NULL;
+        }
+        nodes[depth++] = node;
+    }
+    for (len = 0; depth--; len = strlen(path)) {
+        last = len;
+        snprintf(&path[len], sizeof path - len, "%s%s", len ? "/" : "",
+                 (char *) nodes[depth]->name);
+    }
+    if (len == sizeof path - 1) {
+        /* possibly truncated */
+        return NULL;
+    }
+
+    h = xmlHashLookup2(edit_handlers_index, BAD_CAST path,
+                       BAD_CAST edit_op_name(op));
+    if (!h && last) {
+        /* any child of the parent */
+        strcpy(&path[last], "/*");
+        h = xmlHashLookup2(edit_handlers_index, BAD_CAST path,
+                           BAD_CAST edit_op_name(op));
+    }
+
+    return h;
+}
+
+/*
+ * Apply the create or delete operation on the node to the OVSDB, the
+ * handler is selected from edit_handlers by the node's schema path.
+ *
+ * @param[in] orig_doc Original configuration document to edit.
+ * @param[in] node Node to create (from the edit-config data) or to delete
+ * (from orig_doc).
+ * @param[in] op NC_EDIT_OP_CREATE or NC_EDIT_OP_DELETE
+ * @param[in] log Flag for logging the deletion
+ * @return Zero on success, non-zero otherwise.
+ */
+static int
+edit_ovs(xmlDocPtr orig_doc, xmlNodePtr node, NC_EDIT_OP_TYPE op, int log,
+         struct nc_err **e)
+{
+    const struct edit_handler *h;
+    const xmlChar *key = NULL, *value;
+    xmlNodePtr iter, data = node;
+    char msg[128];
+    int i, ret = EXIT_SUCCESS;
+
+    h = edit_handler_find(node, op);
+    if (!h) {
+        nc_verb_warning("%s: unknown element %s (parent: %s)", __func__,
+                        (const char *) node->name,
+                        (const char *) node->parent->name);
+        return EXIT_SUCCESS;
+    }
+
+    if (h->key_name) {
+        for (iter = node, i = 0; i < h->key_level; i++) {
+            iter = iter->parent;
+        }
+        key = get_key(iter, h->key_name);
+        if (!key && (h->flags & EDIT_F_KEY_REQUIRED)) {
+            *e = nc_err_new(NC_ERR_MISSING_ELEM);
+            nc_err_set(*e, NC_ERR_PARAM_INFO_BADELEM, h->key_name);
+            snprintf(msg, sizeof msg, "Missing %s's %s",
+                     (char *) iter->name, h->key_name);
+            nc_err_set(*e, NC_ERR_PARAM_MSG, msg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    value = node->children ? node->children->content : NULL;
+    if (!value && (h->flags & EDIT_F_LEAFREF)) {
+        *e = nc_err_new(NC_ERR_BAD_ELEM);
+        nc_err_set(*e, NC_ERR_PARAM_MSG, "invalid resources leafref");
+        nc_err_set(*e, NC_ERR_PARAM_INFO_BADELEM, (char *) node->name);
+        return EXIT_FAILURE;
+    }
+    if (h->flags & EDIT_F_CLEAR) {
+        value = NULL;
+        data = NULL;
+    }
+
+    switch (h->call) {
+    case EDIT_CALL_IGNORE:
+        break;
+    case EDIT_CALL_CHILDREN:
+        while (node->children) {
+            if (op == NC_EDIT_OP_CREATE) {
+                ret = edit_create(orig_doc, node->children, 1, e);
+            } else {
+                ret = edit_delete(node->children, 1, log, e);
+            }
+            if (ret) {
+                break;
+            }
+        }
+        break;
+    case EDIT_CALL_VOID:
+        ret = h->fn.fn_void(e);
+        break;
+    case EDIT_CALL_NODE:
+        ret = h->fn.node(data, e);
+        break;
+    case EDIT_CALL_KEY:
+        ret = h->fn.key(key, e);
+        break;
+    case EDIT_CALL_KEY_VALUE:
+        ret = h->fn.key_value(key, value, e);
+        break;
+    case EDIT_CALL_KEY_NODE:
+        ret = h->fn.key_node(key, data, e);
+        break;
+    case EDIT_CALL_KEY_NAME_VALUE:
+        ret = h->fn.key_name_value(key, node->name, value, e);
+        break;
+    case EDIT_CALL_KEY_NAME_NODE:
+        ret = h->fn.key_name_node(key, (char *) node->name, data, e);
+        break;
+    case EDIT_CALL_KEY_CHILDREN:
+        for (iter = node->children; iter; iter = iter->next) {
+            if ((ret = h->fn.key_node(key, iter, e))) {
+                break;
+            }
+        }
+        break;
+    }
+
+    return ret;
+}
+
 /**
  * \brief Perform edit-config's "delete" operation on the selected node.
  *
@@ -1120,8 +1875,6 @@ error:
 static int
 edit_delete(xmlNodePtr node, int running, int log, struct nc_err **e)
 {
-    xmlNodePtr child;
-    const xmlChar *key, *aux;
     int ret = EXIT_SUCCESS;
 
     if (!node) {
@@ -1139,215 +1892,12 @@ edit_delete(xmlNodePtr node, int running, int log, struct nc_err **e)
             goto end;
         }
 
-        if (node->parent->type == XML_DOCUMENT_NODE) {
-            /* capable-switch node */
-
-            /* removing root */
-            return txn_del_all(e);
-        }
-
-        if (xmlStrEqual(node->parent->name, BAD_CAST "capable-switch")) {
-            if (xmlStrEqual(node->name, BAD_CAST "id")) {
-                ofc_set_switchid(NULL);
-            } else {            /* resources, logical-switches */
-                while (node->children) {
-                    if ((ret = edit_delete(node->children, running, log, e))) {
-                        /* failure */
-                        break;
-                    }
-                }
-            }
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "resources")) {
-            if (xmlStrEqual(node->parent->parent->name,
-                            BAD_CAST "capable-switch")) {
-                if (xmlStrEqual(node->name, BAD_CAST "port")) {
-                    key = get_key(node, "name");
-                    ret = txn_del_port(key, e);
-                } else if (xmlStrEqual(node->name, BAD_CAST "queue")) {
-                    key = get_key(node, "resource-id");
-                    ret = txn_del_queue(key, e);
-                } else if (xmlStrEqual(node->name,
-                                       BAD_CAST "owned-certificate")) {
-                    ret = txn_del_owned_certificate(node, e);
-                } else if (xmlStrEqual(node->name,
-                                       BAD_CAST "external-certificate")) {
-                    ret = txn_del_external_certificate(node, e);
-                } else if (xmlStrEqual(node->name, BAD_CAST "flow-table")) {
-                    key = get_key(node, "table-id");
-                    ret = txn_del_flow_table(key, e);
-                } else {
-                    nc_verb_warning("%s: unknown element %s (parent: %s)",
-                                    __func__, (const char *) node->name,
-                                    (const char *) node->parent->name);
-                }
-            } else {            /* logical-switch */
-                /* get bridge name */
-                key = get_key(node->parent->parent, "id");
-
-                /* get leaf-ref value */
-                aux = node->children ? node->children->content : NULL;
-                if (!aux) {
-                    *e = nc_err_new(NC_ERR_BAD_ELEM);
-                    nc_err_set(*e, NC_ERR_PARAM_MSG,
-                               "invalid resources leafref");
-                    nc_err_set(*e, NC_ERR_PARAM_INFO_BADELEM,
-                               (char *) node->name);
-                    ret = EXIT_FAILURE;
-                } else if (xmlStrEqual(node->name, BAD_CAST "port")) {
-                    ret = txn_del_bridge_port(key, aux, e);
-                } else if (xmlStrEqual(node->name, BAD_CAST "flow-table")) {
-                    ret = txn_del_bridge_flowtable(key, aux, e);
-                }
-                /* certificate is ignored on purpose! Once defined, it is
-                 * automatically referenced and used in every bridge. */
-                /* queue is ignored on purpose! It is linked with the port,
-                 * reference here is only informative
-                 */
-            }
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "port")) {
-            if (xmlStrEqual(node->name, BAD_CAST "requested-number")) {
-                key = get_key(node->parent, "name");
-                ret = txn_mod_port_reqnumber(key, NULL, e);
-            } else if (xmlStrEqual(node->name, BAD_CAST "ipgre-tunnel")
-                       || xmlStrEqual(node->name, BAD_CAST "vxlan-tunnel")
-                       || xmlStrEqual(node->name, BAD_CAST "tunnel")) {
-                key = get_key(node->parent, "name");
-                ret = txn_del_port_tunnel(key, node, e);
-            } else if (xmlStrEqual(node->name, BAD_CAST "features")) {
-                child = go2node(node, BAD_CAST "advertised");
-                if (child) {
-                    ret = edit_delete(child, running, log, e);
-                }
-            } else {
-                /* configuration */
-                while (node->children) {
-                    ret = edit_delete(node->children, running, log, e);
-                    if (ret) {
-                        break;
-                    }
-                }
-            }
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "configuration")) {
-            /* no-receive, no-forward, no-packet-in, admin-state */
-            key = get_key(node->parent->parent, "name");
-
-            /* delete -> set to default */
-            ret = of_mod_port_cfg(key, node->name, NULL, e);
-        } else if (xmlStrEqual(node->name, BAD_CAST "advertised")) {
-            key = get_key(node->parent->parent, "name");
-            for (child = node->children; child; child = child->next) {
-                if ((ret = txn_del_port_advert(key, child, e))) {
-                    break;
-                }
-            }
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "advertised")) {
-            key = get_key(node->parent->parent->parent, "name");
-            ret = txn_del_port_advert(key, node, e);
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "ipgre-tunnel")
-                || xmlStrEqual(node->parent->name, BAD_CAST "vxlan-tunnel")
-                || xmlStrEqual(node->parent->name, BAD_CAST "tunnel")) {
-            key = get_key(node->parent->parent, "name");
-            ret = txn_mod_port_tunnel_opt(key, node->name, NULL, e);
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "queue")) {
-            if (xmlStrEqual(node->name, BAD_CAST "port")) {
-                key = get_key(node->parent, "resource-id");
-                ret = txn_del_queue_port(key, e);
-            } else if (xmlStrEqual(node->name, BAD_CAST "properties")) {
-                while (node->children) {
-                    if ((ret = edit_delete(node->children, running, log, e))) {
-                        break;
-                    }
-                }
-            }
-            /* id is ignored on purpose. It is mandatory value and delete as
-             * part of replace is not needed since the subsequent create
-             * allows to replace the current value directly */
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "properties")) {
-            key = get_key(node->parent->parent, "resource-id");
-            ret = txn_mod_queue_options(key, (char *) node->name, NULL, e);
-        } else if (xmlStrEqual(node->parent->name,
-                               BAD_CAST "owned-certificate")) {
-            key = get_key(node->parent, "resource-id");
-            ret = txn_mod_own_cert_certificate(key, NULL, e);
-        } else if (xmlStrEqual(node->name, BAD_CAST "private-key")) {
-            while (node->children) {
-                ret = edit_delete(node->children, running, log, e);
-                if (ret) {
-                    break;
-                }
-            }
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "private-key")) {
-            key = get_key(node->parent->parent, "resource-id");
-
-            if (xmlStrEqual(node->name, BAD_CAST "key-type")) {
-                ret = txn_mod_own_cert_key_type(key, NULL, e);
-            } else if (xmlStrEqual(node->name, BAD_CAST "key-data")) {
-                ret = txn_mod_own_cert_key_data(key, NULL, e);
-            } else {
-                nc_verb_warning("%s: unknown element %s (parent: %s)",
-                                __func__, (const char *) node->name,
-                                (const char *) node->parent->name);
-            }
-        } else if (xmlStrEqual(node->parent->name,
-                               BAD_CAST "external-certificate")) {
-            key = get_key(node->parent, "resource-id");
-            ret = txn_mod_ext_cert_certificate(key, NULL, e);
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "flow-table")) {
-            /* key 'table-id' cannot be deleted */
-            key = get_key(node->parent, "table-id");
-            if (xmlStrEqual(node->name, BAD_CAST "name")) {
-                ret = txn_mod_flowtable_name(key, NULL, e);
-            } else if (xmlStrEqual(node->name, BAD_CAST "resource-id")) {
-                ret = txn_mod_flowtable_resid(key, NULL, e);
-            }
-        } else if (xmlStrEqual(node->name, BAD_CAST "switch")) {
-            /* remove bridge */
-            key = get_key(node, "id");
-            ret = txn_del_bridge(key, e);
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "switch")) {
-            key = get_key(node->parent, "id");
-
-            /* key (id) cannot be deleted */
-            if (xmlStrEqual(node->name, BAD_CAST "datapath-id")) {
-                ret = txn_mod_bridge_datapath(key, NULL, e);
-            } else if (xmlStrEqual(node->name, BAD_CAST "controllers")
-                       || xmlStrEqual(node->name, BAD_CAST "resources")) {
-                while (node->children) {
-                    /* controller, content of resources (port, queue, ...) */
-                    if ((ret = edit_delete(node->children, running, log, e))) {
-                        break;
-                    }
-                }
-            } else
-                if (xmlStrEqual
-                    (node->name, BAD_CAST "lost-connection-behavior")) {
-                ret = txn_mod_bridge_failmode(key, NULL, e);
-            }
-            /* enabled is not handled: it is too complicated to handle it in
-             * combination with the OVSDB's garbage collection. */
-        } else if (xmlStrEqual(node->name, BAD_CAST "controller")) {
-            key = get_key(node, "id");  /* controller id */
-            aux = get_key(node->parent->parent, "id");  /* bridge id */
-            ret = txn_del_contr(key, aux, e);
-        } else if (xmlStrEqual(node->parent->name, BAD_CAST "controller")) {
-            key = get_key(node->parent, "id");
-            /* key 'id' cannot be deleted */
-            if (xmlStrEqual(node->name, BAD_CAST "local-ip-address")) {
-                ret = txn_mod_contr_lip(key, NULL, e);
-            } else if (xmlStrEqual(node->name, BAD_CAST "ip-address")
-                       || xmlStrEqual(node->name, BAD_CAST "port")
-                       || xmlStrEqual(node->name, BAD_CAST "protocol")) {
-                ret = txn_mod_contr_target(key, node->name, NULL, e);
-            }
-        } else {
-            nc_verb_warning("%s: Unknown element %s (parent: %s)", __func__,
-                            (const char *) node->name,
-                            (const char *) node->parent->name);
-        }
+        ret = edit_ovs(NULL, node, NC_EDIT_OP_DELETE, log, e);
     }
 
 end:
     if (!ret) {
+        equiv_index_remove(node);
         xmlUnlinkNode(node);
         xmlFreeNode(node);
     }
@@ -1384,6 +1934,32 @@ edit_remove(xmlDocPtr orig_doc, xmlNodePtr edit_node, int running,
     return EXIT_SUCCESS;
 }
 
+/**
+ * \brief Perform edit-config's "delete" operation on the selected node.
+ *
+ * Unlike "remove", the node's equivalent must exist.
+ *
+ * \param[in] orig_doc Original configuration document to edit.
+ * \param[in] edit_node Node from the edit-config's \<config\> element with
+ * the specified "delete" operation.
+ * @param[in] running Flag for applying changes to the OVSDB
+ *
+ * \return Zero on success, non-zero otherwise.
+ */
+static int
+edit_delete_equiv(xmlDocPtr orig_doc, xmlNodePtr edit_node, int running,
+                  struct nc_err **error)
+{
+    if (find_element_equiv(orig_doc, edit_node) == NULL) {
+        if (error != NULL) {
+            *error = nc_err_new(NC_ERR_DATA_MISSING);
+        }
+        return EXIT_FAILURE;
+    }
+
+    return edit_remove(orig_doc, edit_node, running, error);
+}
+
 /**
  * \brief Perform edit-config's "replace" operation on the selected node.
  *
@@ -1479,10 +2055,48 @@ edit_create_r(xmlDocPtr orig_doc, xmlNodePtr edit, struct nc_err **error)
             ns_aux = xmlNewNs(retval, edit->ns->href, NULL);
             xmlSetNs(retval, ns_aux);
         }
+        equiv_index_add(retval);
     }
     return retval;
 }
 
+/*
+ * Copy the edit node into the XML tree, its missing ancestors are created as
+ * well.
+ *
+ * \param[in] orig_doc Original configuration document to edit.
+ * \param[in] edit Node from the edit-config's \<config\> element to copy.
+ *
+ * \return Zero on success, non-zero otherwise.
+ */
+static int
+edit_create_xml(xmlDocPtr orig_doc, xmlNodePtr edit, struct nc_err **e)
+{
+    xmlNodePtr parent, copy, node;
+
+    if (edit->parent->type != XML_DOCUMENT_NODE) {
+        parent = edit_create_r(orig_doc, edit->parent, e);
+        if (!parent) {
+            return EXIT_FAILURE;
+        }
+    } else {
+        /* we are in the root */
+        parent = (xmlNodePtr) (orig_doc);
+    }
+
+    node = copy = xmlCopyNode(edit, 1);
+    if (parent->type == XML_DOCUMENT_NODE) {
+        xmlDocSetRootElement(parent->doc, node);
+    } else if ((node = xmlAddChild(parent, copy)) == NULL) {
+        nc_verb_error("Creating new node (%s) failed", edit->name);
+        xmlFreeNode(copy);
+        return (EXIT_FAILURE);
+    }
+    equiv_index_add(node);
+
+    return EXIT_SUCCESS;
+}
+
 /**
  * \brief Perform edit-config's "create" operation on the selected node.
  *
@@ -1497,8 +2111,8 @@ static int
 edit_create(xmlDocPtr orig_doc, xmlNodePtr edit, int running,
             struct nc_err **e)
 {
-    xmlNodePtr parent, child;
-    const xmlChar *key, *aux;
+    static int running_depth = 0;
+    xmlNodePtr mirror = NULL;
     int ret = EXIT_SUCCESS;
 
     /* remove operation attribute */
@@ -1509,282 +2123,40 @@ edit_create(xmlDocPtr orig_doc, xmlNodePtr edit, int running,
     nc_verb_verbose("Creating the node %s", (char *) edit->name);
     if (running) {
         /* OVS */
-        if (edit->type != XML_ELEMENT_NODE) {
-            /* skip processing comments and simply removes them */
-            goto end;
+        if (running_depth++ == 0 && edit->type == XML_ELEMENT_NODE) {
+            /* the applied data are mirrored into orig_doc when the outermost
+             * create succeeds */
+            mirror = xmlCopyNode(edit, 1);
         }
 
-        if (edit->parent->type == XML_DOCUMENT_NODE) {
-            /* creating whole capable-switch */
-            /* check presence of mandatory id */
-            key = get_key(edit, "id");
-            if (!key) {
-                *e = nc_err_new(NC_ERR_MISSING_ELEM);
-                nc_err_set(*e, NC_ERR_PARAM_INFO_BADELEM, "id");
-                nc_err_set(*e, NC_ERR_PARAM_MSG,
-                           "Missing capable-switch's id");
-                ret = EXIT_FAILURE;
-                goto end;
-            }
-
-            /* set it all */
-            while (edit->children) {
-                ret = edit_create(orig_doc, edit->children, running, e);
-                if (ret) {
-                    break;
-                }
-            }
+        if (edit->type != XML_ELEMENT_NODE) {
+            /* skip processing comments and simply removes them */
             goto end;
         }
 
-        if (xmlStrEqual(edit->parent->name, BAD_CAST "capable-switch")) {
-            if (xmlStrEqual(edit->name, BAD_CAST "id")) {
-                ofc_set_switchid(edit);
-            } else {            /* resources and local-switches */
-                /* nothing to do on this level, continue with creating
-                 * children */
-                while (edit->children) {
-                    ret = edit_create(orig_doc, edit->children, running, e);
-                    if (ret) {
-                        break;
-                    }
-                }
-            }
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "resources")) {
-            if (xmlStrEqual
-                (edit->parent->parent->name, BAD_CAST "capable-switch")) {
-                if (xmlStrEqual(edit->name, BAD_CAST "port")) {
-                    ret = txn_add_port(edit, e);
-                } else if (xmlStrEqual(edit->name, BAD_CAST "queue")) {
-                    ret = txn_add_queue(edit, e);
-                } else if (xmlStrEqual(edit->name,
-                                       BAD_CAST "owned-certificate")) {
-                    ret = txn_add_owned_certificate(edit, e);
-                } else if (xmlStrEqual(edit->name,
-                                       BAD_CAST "external-certificate")) {
-                    ret = txn_add_external_certificate(edit, e);
-                } else if (xmlStrEqual(edit->name, BAD_CAST "flow-table")) {
-                    ret = txn_add_flow_table(edit, e);
-                } else {
-                    nc_verb_warning("%s: unknown element %s (parent: %s)",
-                                    __func__, (const char *) edit->name,
-                                    (const char *) edit->parent->name);
-                }
-            } else {            /* logical-switch */
-                /* get bridge name */
-                key = get_key(edit->parent->parent, "id");
-
-                /* get leaf-ref value */
-                aux = edit->children ? edit->children->content : NULL;
-                if (!aux) {
-                    *e = nc_err_new(NC_ERR_BAD_ELEM);
-                    nc_err_set(*e, NC_ERR_PARAM_MSG,
-                               "invalid resources leafref");
-                    nc_err_set(*e, NC_ERR_PARAM_INFO_BADELEM,
-                               (char *) edit->name);
-                    ret = EXIT_FAILURE;
-                } else if (xmlStrEqual(edit->name, BAD_CAST "port")) {
-                    ret = txn_add_bridge_port(key, aux, e);
-                } else if (xmlStrEqual(edit->name, BAD_CAST "flow-table")) {
-                    ret = txn_add_bridge_flowtable(key, aux, e);
-                } else if (xmlStrEqual(edit->name, BAD_CAST "queue")) {
-                    /* reference here is only informative, so inform client
-                     * that some other change is expected. But first, check
-                     * that such a change was not performed
-                     */
-                    switch (ofc_check_bridge_queue(key, aux)) {
-                    case 1:
-                        *e = nc_err_new(NC_ERR_BAD_ELEM);
-                        nc_err_set(*e, NC_ERR_PARAM_INFO_BADELEM, "queue");
-                        nc_err_set(*e, NC_ERR_PARAM_MSG,
-                                   "Invalid queue leafref");
-                        ret = EXIT_FAILURE;
-                        break;
-                    case 2:
-                        *e = nc_err_new(NC_ERR_OP_FAILED);
-                        nc_err_set(*e, NC_ERR_PARAM_MSG,
-                                   "Assigning queue to the bridge (port) must "
-                                   "be done by the port element in the queue");
-                        ret = EXIT_FAILURE;
-                        break;
-                    default:
-                        /* everything was done elsewhere, so we are done */
-                        break;
-                    }
-                }
-                /* certificate is ignored on purpose! Once defined, it is
-                 * automatically referenced and used in every bridge. */
-            }
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "port")) {
-            if (xmlStrEqual(edit->name, BAD_CAST "requested-number")) {
-                key = get_key(edit->parent, "name");
-                aux = edit->children ? edit->children->content : NULL;
-                ret = txn_mod_port_reqnumber(key, aux, e);
-            } else if (xmlStrEqual(edit->name, BAD_CAST "ipgre-tunnel")
-                    || xmlStrEqual(edit->name, BAD_CAST "vxlan-tunnel")
-                    || xmlStrEqual(edit->name, BAD_CAST "tunnel")) {
-                key = get_key(edit->parent, "name");
-                ret = txn_add_port_tunnel(key, edit, e);
-                /* TODO: remove previous branch of choice */
-            } else if (xmlStrEqual(edit->name, BAD_CAST "features")) {
-                child = go2node(edit, BAD_CAST "advertised");
-                if (child) {
-                    ret = edit_create(orig_doc, child, running, e);
-                }
-            } else {
-                /* configuration */
-                while (edit->children) {
-                    ret = edit_create(orig_doc, edit->children, running, e);
-                    if (ret) {
-                        break;
-                    }
-                }
-            }
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "configuration")) {
-            /* no-receive, no-forward, no-packet-in, admin-state */
-            key = get_key(edit->parent->parent, "name");
-            aux = edit->children ? edit->children->content : NULL;
-            ret = of_mod_port_cfg(key, edit->name, aux, e);
-        } else if (xmlStrEqual(edit->name, BAD_CAST "advertised")) {
-            key = get_key(edit->parent->parent, "name");
-            for (child = edit->children; child; child = child->next) {
-                if ((ret = txn_add_port_advert(key, child, e))) {
-                    break;
-                }
-            }
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "advertised")) {
-            key = get_key(edit->parent->parent->parent, "name");
-            ret = txn_add_port_advert(key, edit, e);
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "ipgre-tunnel")
-                || xmlStrEqual(edit->parent->name, BAD_CAST "vxlan-tunnel")
-                || xmlStrEqual(edit->parent->name, BAD_CAST "tunnel")) {
-            key = get_key(edit->parent->parent, "name");
-            aux = edit->children ? edit->children->content : NULL;
-            ret = txn_mod_port_tunnel_opt(key, edit->name, aux, e);
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "queue")) {
-            if (xmlStrEqual(edit->name, BAD_CAST "id")) {
-                /* must be here, id is not the key -> it can be changed */
-                key = get_key(edit->parent, "resource-id");
-                aux = edit->children ? edit->children->content : NULL;
-                ret = txn_mod_queue_id(key, aux, e);
-            } else if (xmlStrEqual(edit->name, BAD_CAST "port")) {
-                key = get_key(edit->parent, "resource-id");
-                aux = edit->children ? edit->children->content : NULL;
-                ret = txn_add_queue_port(key, aux, e);
-            } else if (xmlStrEqual(edit->name, BAD_CAST "properties")) {
-                while (edit->children) {
-                    ret = edit_create(orig_doc, edit->children, running, e);
-                    if (ret) {
-                        break;
-                    }
-                }
-            }
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "properties")) {
-            key = get_key(edit->parent->parent, "resource-id");
-            ret = txn_mod_queue_options(key, (char *) edit->name, edit, e);
-        } else if (xmlStrEqual(edit->name, BAD_CAST "private-key")) {
-            while (edit->children) {
-                ret = edit_create(orig_doc, edit->children, running, e);
-                if (ret) {
-                    break;
-                }
-            }
-        } else if (xmlStrEqual(edit->parent->name,
-                               BAD_CAST "owned-certificate")) {
-            key = get_key(edit->parent, "resource-id");
-            ret = txn_mod_own_cert_certificate(key, edit, e);
-        } else if (xmlStrEqual(edit->parent->name,
-                               BAD_CAST "external-certificate")) {
-            key = get_key(edit->parent, "resource-id");
-            ret = txn_mod_ext_cert_certificate(key, edit, e);
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "private-key")) {
-            key = get_key(edit->parent->parent, "resource-id");
-            if (xmlStrEqual(edit->name, BAD_CAST "key-type")) {
-                ret = txn_mod_own_cert_key_type(key, edit, e);
-            } else if (xmlStrEqual(edit->name, BAD_CAST "key-data")) {
-                ret = txn_mod_own_cert_key_data(key, edit, e);
-            } else {
-                nc_verb_warning("%s: unknown element %s (parent: %s)",
-                                __func__, (const char *) edit->name,
-                                (const char *) edit->parent->name);
-            }
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "flow-table")) {
-            /* key 'table-id' */
-            key = get_key(edit->parent, "table-id");
-            if (xmlStrEqual(edit->name, BAD_CAST "name")) {
-                ret = txn_mod_flowtable_name(key, edit, e);
-            } else if (xmlStrEqual(edit->name, BAD_CAST "resource-id")) {
-                ret = txn_mod_flowtable_resid(key, edit, e);
-            }
-        } else if (xmlStrEqual(edit->name, BAD_CAST "switch")) {
-            /* create bridge */
-            ret = txn_add_bridge(edit, e);
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "switch")) {
-            key = get_key(edit->parent, "id");
-
-            /* key (id) cannot be added separately */
-            if (xmlStrEqual(edit->name, BAD_CAST "datapath-id")) {
-                aux = edit->children ? edit->children->content : NULL;
-                ret = txn_mod_bridge_datapath(key, aux, e);
-            } else if (xmlStrEqual(edit->name, BAD_CAST "controllers")
-                       || xmlStrEqual(edit->name, BAD_CAST "resources")) {
-                while (edit->children) {
-                    /* controller, content of resources (port, queue, ...) */
-                    ret = edit_create(orig_doc, edit->children, running, e);
-                    if (ret) {
-                        break;
-                    }
-                }
-            } else
-                if (xmlStrEqual
-                    (edit->name, BAD_CAST "lost-connection-behavior")) {
-                aux = edit->children ? edit->children->content : NULL;
-                ret = txn_mod_bridge_failmode(key, aux, e);
-            }
-            /* enabled is not handled: it is too complicated to handle it in
-             * combination with the OVSDB's garbage collection. */
-        } else if (xmlStrEqual(edit->name, BAD_CAST "controller")) {
-            key = get_key(edit->parent->parent, "id");
-            ret = txn_add_contr(edit, key, e);
-        } else if (xmlStrEqual(edit->parent->name, BAD_CAST "controller")) {
-            key = get_key(edit->parent, "id");
-            /* key 'id' cannot be deleted */
-            aux = edit->children ? edit->children->content : NULL;
-            if (xmlStrEqual(edit->name, BAD_CAST "local-ip-address")) {
-                ret = txn_mod_contr_lip(key, aux, e);
-            } else if (xmlStrEqual(edit->name, BAD_CAST "ip-address")
-                       || xmlStrEqual(edit->name, BAD_CAST "port")
-                       || xmlStrEqual(edit->name, BAD_CAST "protocol")) {
-                ret = txn_mod_contr_target(key, edit->name, aux, e);
-            }
-        } else {
-            nc_verb_warning("%s: unknown element %s (parent: %s)", __func__,
-                            (const char *) edit->name,
-                            (const char *) edit->parent->name);
-        }
+        ret = edit_ovs(orig_doc, edit, NC_EDIT_OP_CREATE, 0, e);
     } else {
         /* XML */
-        if (edit->parent->type != XML_DOCUMENT_NODE) {
-            parent = edit_create_r(orig_doc, edit->parent, e);
-            if (!parent) {
-                return EXIT_FAILURE;
-            }
-        } else {
-            /* we are in the root */
-            parent = (xmlNodePtr) (orig_doc);
+        if (edit_create_xml(orig_doc, edit, e)) {
+            return EXIT_FAILURE;
         }
+    }
 
-        if (parent->type == XML_DOCUMENT_NODE) {
-            xmlDocSetRootElement(parent->doc, xmlCopyNode(edit, 1));
-        } else {
-            if (xmlAddChild(parent, xmlCopyNode(edit, 1)) == NULL) {
-                nc_verb_error("Creating new node (%s) failed", edit->name);
-                return (EXIT_FAILURE);
-            }
+end:
+    if (running && --running_depth == 0 && mirror) {
+        if (!ret && !find_element_equiv(orig_doc, edit)) {
+            /* keep orig_doc in sync with the OVSDB; the children of the edit
+             * node were consumed by the nested edit_create() calls, so put
+             * its complete copy in its place */
+            xmlReplaceNode(edit, mirror);
+            xmlFreeNode(edit);
+            edit = mirror;
+            mirror = NULL;
+            ret = edit_create_xml(orig_doc, edit, e);
         }
+        xmlFreeNode(mirror);
     }
 
-end:
     /* remove the node from the edit document */
     if (!ret) {
         edit_delete(edit, 0, 0, NULL);
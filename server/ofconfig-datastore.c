@@ -22,6 +22,7 @@
 #include <config.h>
 
 #include <assert.h>
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -30,6 +31,7 @@
 #include <sys/types.h>
 
 #include <libnetconf.h>
+#include <libnetconf_xml.h>
 
 /* libovs */
 #include <dirs.h>
@@ -107,6 +109,7 @@ void
 ofcds_free(void *UNUSED(data))
 {
     ofc_destroy();
+    edit_handlers_destroy();
 
     /* dump startup to persistent storage */
     if (gds_startup) {
@@ -248,6 +251,16 @@ ofcds_getconfig(void *UNUSED(data), NC_DATASTORE target, struct nc_err **error)
 
     switch (target) {
     case NC_DATASTORE_RUNNING:
+        if (ofc_commit_pending() && rollback.type == NC_DATASTORE_RUNNING) {
+            /* OVSDB shows the changes of the commit in progress, serve the
+             * last committed configuration */
+            if (!rollback.doc || !xmlDocGetRootElement(rollback.doc)) {
+                config_data = xmlStrdup(BAD_CAST "");
+            } else {
+                xmlDocDumpMemory(rollback.doc, &config_data, NULL);
+            }
+            break;
+        }
         /* If there is no id of the capable-switch (no configuration data were
          * provided), continue as there is no OVSDB */
         return ofc_get_config_data();
@@ -309,8 +322,7 @@ ofcds_editconfig(void *UNUSED(data), const nc_rpc * UNUSED(rpc),
                  NC_EDIT_ERROPT_TYPE UNUSED(errop), struct nc_err **error)
 {
     int ret = EXIT_FAILURE, running = 0;
-    char *aux;
-    int cfgds_new = 0;
+    int cfgds_new = 0, patched = 0;
     xmlDocPtr cfgds = NULL, cfg = NULL, cfg_clone = NULL;
     xmlNodePtr rootcfg;
 
@@ -332,16 +344,13 @@ ofcds_editconfig(void *UNUSED(data), const nc_rpc * UNUSED(rpc),
     switch (target) {
     case NC_DATASTORE_RUNNING:
         /* Make a copy of parsed config - we will find port/configuration in
-         * it.  It is used after txn_commit(). */
+         * it.  It is used after the commit, see txn_commit_start(). */
         cfg_clone = xmlCopyDoc(cfg, 1);
 
-        aux = ofc_get_config_data();
-        if (!aux) {
+        if (ofc_get_running_doc(&cfgds)) {
             *error = nc_err_new(NC_ERR_OP_FAILED);
             goto error_cleanup;
         }
-        cfgds = xmlReadMemory(aux, strlen(aux), NULL, NULL, XML_READ_OPT);
-        free(aux);
 
         running = 1;
         break;
@@ -357,7 +366,11 @@ ofcds_editconfig(void *UNUSED(data), const nc_rpc * UNUSED(rpc),
         nc_err_set(*error, NC_ERR_PARAM_INFO_BADELEM, "target");
         goto error_cleanup;
     }
-    store_rollback(xmlCopyDoc(cfgds, 1), target);
+    if (!running || !ofc_commit_pending()) {
+        /* keep the last committed configuration while the edits of a group
+         * are collected, it is served by ofcds_getconfig() */
+        store_rollback(xmlCopyDoc(cfgds, 1), target);
+    }
 
     /* check keys in config's lists */
     ret = check_keys(cfg, error);
@@ -365,34 +378,16 @@ ofcds_editconfig(void *UNUSED(data), const nc_rpc * UNUSED(rpc),
         goto error_cleanup;
     }
 
-    /* check operations */
-    ret = check_edit_ops(NC_EDIT_OP_DELETE, defop, cfgds, cfg, error);
-    if (ret != EXIT_SUCCESS) {
-        goto error_cleanup;
-    }
-    ret = check_edit_ops(NC_EDIT_OP_CREATE, defop, cfgds, cfg, error);
-    if (ret != EXIT_SUCCESS) {
-        goto error_cleanup;
-    }
-
     if (target == NC_DATASTORE_RUNNING) {
         txn_init();
     }
 
-    ret = compact_edit_operations(cfg, defop);
-    if (ret != EXIT_SUCCESS) {
-        nc_verb_error("Compacting edit-config operations failed.");
-        if (error != NULL) {
-            *error = nc_err_new(NC_ERR_OP_FAILED);
-        }
-        goto error_cleanup;
-    }
-
-    /* perform operations */
+    /* check and perform operations */
     if (!cfgds) {
         cfgds_new = 1;
         cfgds = xmlNewDoc(BAD_CAST "1.0");
     }
+    patched = 1;
     ret = edit_operations(cfgds, cfg, defop, running, error);
     if (ret != EXIT_SUCCESS) {
         goto error_cleanup;
@@ -406,16 +401,9 @@ ofcds_editconfig(void *UNUSED(data), const nc_rpc * UNUSED(rpc),
     }
 
     if (target == NC_DATASTORE_RUNNING) {
-        ret = txn_commit(error);
-
-        if (ret == EXIT_SUCCESS) {
-            /* modify port/configuration of ports that were created */
-            ret = of_post_ports(xmlDocGetRootElement(cfg_clone), error);
-        }
-        /* config clone was used and it is not needed by now */
-        xmlFreeDoc(cfg_clone);
-
-        xmlFreeDoc(cfgds);
+        /* the reply waits for OVSDB in the server, both documents are
+         * finished with the commit */
+        ret = txn_commit_start(cfgds, cfg_clone, error);
     } else if (cfgds_new){
         if (cfgds->children) {
             /* document changed, because we started with empty document */
@@ -438,6 +426,11 @@ error_cleanup:
     if (target == NC_DATASTORE_RUNNING) {
         txn_abort();
         xmlFreeDoc(cfg_clone);
+        if (patched) {
+            /* the document can be partially patched */
+            ofc_put_running_doc(cfgds, false);
+        }
+    } else if (cfgds_new) {
         xmlFreeDoc(cfgds);
     }
     xmlFreeDoc(cfg);
@@ -450,7 +443,6 @@ ofcds_copyconfig(void *UNUSED(data), NC_DATASTORE target,
                  NC_DATASTORE source, char *config, struct nc_err **error)
 {
     int ret = EXIT_FAILURE;
-    char *s;
     xmlDocPtr src_doc = NULL;
     xmlDocPtr dst_doc = NULL;
     xmlNodePtr root;
@@ -461,14 +453,11 @@ ofcds_copyconfig(void *UNUSED(data), NC_DATASTORE target,
 
     switch (source) {
     case NC_DATASTORE_RUNNING:
-        s = ofcds_getconfig(NULL, NC_DATASTORE_RUNNING, error);
-        if (!s) {
+        if (ofc_get_config_doc(&src_doc)) {
             nc_verb_error
                 ("copy-config: unable to get running source repository");
             return EXIT_FAILURE;
         }
-        src_doc = xmlReadMemory(s, strlen(s), NULL, NULL, XML_READ_OPT);
-        free(s);
         if (!src_doc) {
             nc_verb_error("copy-config: invalid running source data");
             *error = nc_err_new(NC_ERR_OP_FAILED);
@@ -507,13 +496,10 @@ ofcds_copyconfig(void *UNUSED(data), NC_DATASTORE target,
     case NC_DATASTORE_RUNNING:
         /* apply source to OVSDB */
 
-        s = ofcds_getconfig(NULL, NC_DATASTORE_RUNNING, error);
-        if (!s) {
+        if (ofc_get_running_doc(&dst_doc)) {
             nc_verb_error("copy-config: unable to get running source data");
             goto cleanup;
         }
-        dst_doc = xmlReadMemory(s, strlen(s), NULL, NULL, XML_READ_OPT);
-        free(s);
 
         root = xmlDocGetRootElement(src_doc);
         if (!dst_doc) {
@@ -525,12 +511,17 @@ ofcds_copyconfig(void *UNUSED(data), NC_DATASTORE target,
         }
 
         txn_init();
+        equiv_index_reset();
         if (edit_replace(dst_doc, root, 1, error)) {
             txn_abort();
-        } else {
+            ofc_put_running_doc(dst_doc, false);
+        } else if (rollbacking) {
             ret = txn_commit(error);
+            ofc_put_running_doc(dst_doc, ret == EXIT_SUCCESS);
+        } else {
+            ret = txn_commit_start(dst_doc, NULL, error);
         }
-        xmlFreeDoc(dst_doc);
+        equiv_index_reset();
         goto cleanup;
         break;
     case NC_DATASTORE_STARTUP:
@@ -605,6 +596,337 @@ ofcds_rollback(void *UNUSED(data))
     return ret;
 }
 
+/* Result of the analysis of the request's subtree filter */
+static struct {
+    unsigned int sections;
+    char **switches;            /* NULL terminated, NULL for all switches */
+    size_t n_switches;
+    int all_switches;
+} filter_hint;
+
+static int
+filter_has_elements(xmlNodePtr node)
+{
+    xmlNodePtr child;
+
+    for (child = node->children; child; child = child->next) {
+        if (child->type == XML_ELEMENT_NODE) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* content match node - leaf element with some (non-whitespace) value */
+static int
+filter_is_content_match(xmlNodePtr node)
+{
+    xmlChar *value;
+    int i, ret = 0;
+
+    if (filter_has_elements(node)) {
+        return 0;
+    }
+    value = xmlNodeGetContent(node);
+    for (i = 0; value && value[i]; i++) {
+        if (!isspace(value[i])) {
+            ret = 1;
+            break;
+        }
+    }
+    xmlFree(value);
+
+    return ret;
+}
+
+/* Add the switch selected by the content match node 'node' (its <id>).  If
+ * the id cannot be taken, all the switches are generated. */
+static void
+filter_add_switch(xmlNodePtr node)
+{
+    xmlChar *value;
+    char **switches;
+    char *id = NULL;
+    size_t start, end;
+
+    value = xmlNodeGetContent(node);
+    if (value) {
+        /* the content match compares the trimmed value */
+        for (start = 0; isspace(value[start]); start++);
+        for (end = xmlStrlen(value); end > start && isspace(value[end - 1]);
+             end--);
+        if (end > start) {
+            id = strndup((char *) value + start, end - start);
+        }
+        xmlFree(value);
+    }
+
+    switches = NULL;
+    if (id) {
+        switches = realloc(filter_hint.switches, (filter_hint.n_switches + 2)
+                                                 * sizeof *switches);
+    }
+    if (!switches) {
+        free(id);
+        filter_hint.all_switches = 1;
+        return;
+    }
+    filter_hint.switches = switches;
+    filter_hint.switches[filter_hint.n_switches++] = id;
+    filter_hint.switches[filter_hint.n_switches] = NULL;
+}
+
+/* true if 'node' has no selection and containment nodes, so it selects the
+ * whole subtree */
+static int
+filter_selects_all(xmlNodePtr node)
+{
+    xmlNodePtr child;
+
+    for (child = node->children; child; child = child->next) {
+        if (child->type == XML_ELEMENT_NODE
+            && !filter_is_content_match(child)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* /capable-switch/resources/port - probes needed for the selected state */
+static unsigned int
+filter_port(xmlNodePtr node)
+{
+    xmlNodePtr child;
+    unsigned int probes = 0;
+
+    if (filter_selects_all(node)) {
+        return OFC_DATA_PORT_PROBES;
+    }
+
+    for (child = node->children; child; child = child->next) {
+        if (child->type != XML_ELEMENT_NODE) {
+            continue;
+        }
+        if (xmlStrEqual(child->name, BAD_CAST "features")) {
+            probes |= OFC_DATA_PORT_FEATURES;
+        } else if (xmlStrEqual(child->name, BAD_CAST "current-rate")
+                   || xmlStrEqual(child->name, BAD_CAST "max-rate")) {
+            /* rates are valid only for the "other" ethtool rate */
+            probes |= OFC_DATA_PORT_PROBES;
+        } else if (xmlStrEqual(child->name, BAD_CAST "state")) {
+            if (filter_selects_all(child)
+                || go2node(child, BAD_CAST "live")) {
+                probes |= OFC_DATA_PORT_OF;
+            }
+        } else if (xmlStrEqual(child->name, BAD_CAST "statistics")) {
+            probes |= OFC_DATA_PORT_STATS;
+        }
+    }
+
+    return probes;
+}
+
+/* /capable-switch/resources/queue and flow-table - the counters are the
+ * only probe, 'probe' is returned if they can be selected */
+static unsigned int
+filter_counters(xmlNodePtr node, unsigned int probe)
+{
+    if (filter_selects_all(node) || go2node(node, BAD_CAST "statistics")) {
+        return probe;
+    }
+    return 0;
+}
+
+/* /capable-switch/resources */
+static unsigned int
+filter_resources(xmlNodePtr node)
+{
+    xmlNodePtr child;
+    unsigned int sections = 0;
+
+    if (!filter_has_elements(node)) {
+        return OFC_DATA_RESOURCES | OFC_DATA_PORT_PROBES
+               | OFC_DATA_QUEUE_STATS | OFC_DATA_FLOW_TABLE_STATS;
+    }
+
+    for (child = node->children; child; child = child->next) {
+        if (child->type != XML_ELEMENT_NODE) {
+            continue;
+        }
+        if (xmlStrEqual(child->name, BAD_CAST "port")) {
+            sections |= OFC_DATA_PORTS | filter_port(child);
+        } else if (xmlStrEqual(child->name, BAD_CAST "queue")) {
+            sections |= OFC_DATA_QUEUES
+                        | filter_counters(child, OFC_DATA_QUEUE_STATS);
+        } else if (xmlStrEqual(child->name, BAD_CAST "owned-certificate")) {
+            sections |= OFC_DATA_OWNED_CERT;
+        } else if (xmlStrEqual(child->name, BAD_CAST "external-certificate")) {
+            sections |= OFC_DATA_EXTERNAL_CERT;
+        } else if (xmlStrEqual(child->name, BAD_CAST "flow-table")) {
+            sections |= OFC_DATA_FLOW_TABLES
+                        | filter_counters(child, OFC_DATA_FLOW_TABLE_STATS);
+        }
+    }
+
+    return sections;
+}
+
+/* /capable-switch/logical-switches/switch - probes needed for the selected
+ * state */
+static unsigned int
+filter_switch(xmlNodePtr node)
+{
+    xmlNodePtr child;
+    unsigned int probes = 0;
+
+    if (filter_selects_all(node)) {
+        return OFC_DATA_SWITCH_PROBES;
+    }
+
+    for (child = node->children; child; child = child->next) {
+        if (child->type != XML_ELEMENT_NODE) {
+            continue;
+        }
+        if (xmlStrEqual(child->name, BAD_CAST "capabilities")) {
+            probes |= OFC_DATA_CAPABILITIES;
+        } else if (xmlStrEqual(child->name, BAD_CAST "controllers")) {
+            probes |= OFC_DATA_CONTROLLERS;
+        }
+    }
+
+    return probes;
+}
+
+/* /capable-switch/logical-switches */
+static unsigned int
+filter_switches(xmlNodePtr node)
+{
+    xmlNodePtr child, id;
+    unsigned int sections = 0;
+
+    if (!filter_has_elements(node)) {
+        filter_hint.all_switches = 1;
+        return OFC_DATA_SWITCHES | OFC_DATA_SWITCH_PROBES;
+    }
+
+    for (child = node->children; child; child = child->next) {
+        if (child->type != XML_ELEMENT_NODE
+            || !xmlStrEqual(child->name, BAD_CAST "switch")) {
+            continue;
+        }
+        sections |= OFC_DATA_SWITCHES | filter_switch(child);
+
+        id = go2node(child, BAD_CAST "id");
+        if (id && filter_is_content_match(id)) {
+            /* only the specified switch */
+            filter_add_switch(id);
+        } else {
+            filter_hint.all_switches = 1;
+        }
+    }
+
+    return sections;
+}
+
+/* /capable-switch */
+static unsigned int
+filter_capable_switch(xmlNodePtr node)
+{
+    xmlNodePtr child;
+    unsigned int sections = 0;
+
+    if (filter_selects_all(node)) {
+        /* without selection and containment nodes, the whole subtree is
+         * selected */
+        filter_hint.all_switches = 1;
+        return OFC_DATA_ALL;
+    }
+
+    for (child = node->children; child; child = child->next) {
+        if (child->type != XML_ELEMENT_NODE) {
+            continue;
+        }
+        if (xmlStrEqual(child->name, BAD_CAST "resources")) {
+            sections |= filter_resources(child);
+        } else if (xmlStrEqual(child->name, BAD_CAST "logical-switches")) {
+            sections |= filter_switches(child);
+        }
+        /* other nodes select only the data out of the resources and
+         * switches sections, they are always generated */
+    }
+
+    return sections;
+}
+
+void
+ofc_filter_set(const nc_rpc *rpc)
+{
+    xmlNodePtr content, node, child;
+    xmlChar *type;
+    int subtree = 0;
+
+    ofc_filter_clear();
+
+    switch (nc_rpc_get_op(rpc)) {
+    case NC_OP_GET:
+    case NC_OP_GETCONFIG:
+        break;
+    default:
+        return;
+    }
+
+    content = ncxml_rpc_get_op_content(rpc);
+    for (node = content; node; node = node->next) {
+        if (node->type == XML_ELEMENT_NODE
+            && xmlStrEqual(node->name, BAD_CAST "filter")) {
+            break;
+        }
+    }
+    if (node) {
+        type = xmlGetProp(node, BAD_CAST "type");
+        subtree = (!type || xmlStrEqual(type, BAD_CAST "subtree"));
+        xmlFree(type);
+    }
+    if (!subtree || !filter_has_elements(node)) {
+        /* no filter or a filter we cannot analyse */
+        xmlFreeNodeList(content);
+        return;
+    }
+
+    filter_hint.sections = 0;
+    for (child = node->children; child; child = child->next) {
+        if (child->type == XML_ELEMENT_NODE
+            && xmlStrEqual(child->name, BAD_CAST "capable-switch")
+            && (!child->ns
+                || xmlStrEqual(child->ns->href,
+                               BAD_CAST "urn:onf:config:yang"))) {
+            filter_hint.sections |= filter_capable_switch(child);
+        }
+    }
+    xmlFreeNodeList(content);
+
+    nc_verb_verbose("Filter limits the data to the sections 0x%x%s.",
+                    filter_hint.sections,
+                    filter_hint.all_switches ? "" : " and selected switches");
+    ofc_set_data_filter(filter_hint.sections,
+                        filter_hint.all_switches ? NULL
+                                                 : filter_hint.switches);
+}
+
+void
+ofc_filter_clear(void)
+{
+    size_t i;
+
+    ofc_set_data_filter(OFC_DATA_ALL, NULL);
+    for (i = 0; i < filter_hint.n_switches; i++) {
+        free(filter_hint.switches[i]);
+    }
+    free(filter_hint.switches);
+    memset(&filter_hint, 0, sizeof filter_hint);
+    filter_hint.sections = OFC_DATA_ALL;
+}
+
 struct ncds_custom_funcs ofcds_funcs = {
     .init = ofcds_init,
     .free = ofcds_free,
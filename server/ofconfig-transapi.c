@@ -71,16 +71,7 @@ xmlDocPtr
 ofc_status_clb(xmlDocPtr UNUSED(model), xmlDocPtr UNUSED(running),
                struct nc_err **UNUSED(err))
 {
-    char *state_data;
-    xmlDocPtr d;
-
-    state_data = ofc_get_state_data();
-    if (state_data != NULL) {
-        d = xmlReadMemory(state_data, strlen(state_data), NULL, NULL, 0);
-        free(state_data);
-        return d;
-    }
-    return (NULL);
+    return ofc_get_state_doc();
 }
 
 /* Mapping between prefixes and namespaces. */
@@ -29,10 +29,15 @@
 
 #include "common.h"
 #include "comm.h"
+#include "data.h"
+#include "server_ops.h"
 
 /* default timeout, ms */
 #define TIMEOUT 500
 
+/* timeout while a commit into OVSDB is in progress, ms */
+#define COMMIT_TIMEOUT 10
+
 /* ietf-netconf-server transAPI structure from netconf-server-transapi.c */
 extern struct transapi server_transapi;
 
@@ -55,16 +60,27 @@ extern char *ovsdb_path;
 static void
 print_usage(char *progname)
 {
-    fprintf(stdout, "Usage: %s [-fh] [-d OVSDB] [-v level]\n", progname);
+    fprintf(stdout, "Usage: %s [-fh] [-d OVSDB] [-t timeout] [-s interval "
+            "[-m staleness]] [-w window [-b size]] [-v level]\n", progname);
+    fprintf(stdout, " -b,--group-size n      maximal number of edits committed together\n"
+                    "                        (default no limit)\n");
     fprintf(stdout, " -d,--db  OVSDB         socket path to communicate with OVSDB\n"
                     "                        (e.g. -d unix://var/run/openvswitch/db.sock)\n");
     fprintf(stdout, " -f,--foreground        run in foreground\n");
     fprintf(stdout, " -h,--help              display help\n");
+    fprintf(stdout, " -m,--max-staleness ms  maximal age of the sampled state data\n"
+                    "                        served to <get> (default twice the interval)\n");
+    fprintf(stdout, " -s,--state-interval ms sample the state data periodically in the\n"
+                    "                        main loop with the given interval\n");
+    fprintf(stdout, " -t,--of-timeout ms     how long a configuration change waits\n"
+                    "                        for a bridge to accept OpenFlow connection\n");
     fprintf(stdout, " -v,--verbose level     verbose output level\n");
+    fprintf(stdout, " -w,--group-window ms   commit the edits of running arriving\n"
+                    "                        within the window together\n");
     exit(0);
 }
 
-#define OPTSTRING "fhv:"
+#define OPTSTRING "b:d:fhm:s:t:v:w:"
 
 /* Signal handler - controls main loop */
 void
@@ -97,17 +113,24 @@ signal_handler(int sig)
 int
 main(int argc, char **argv)
 {
-    const char *optstring = "d:fhv:";
+    const char *optstring = "b:d:fhm:s:t:v:w:";
 
     const struct option longopts[] = {
+        {"group-size", required_argument, 0, 'b'},
         {"db", required_argument, 0, 'd'},
         {"foreground", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
+        {"max-staleness", required_argument, 0, 'm'},
+        {"state-interval", required_argument, 0, 's'},
+        {"of-timeout", required_argument, 0, 't'},
         {"verbose", required_argument, 0, 'v'},
+        {"group-window", required_argument, 0, 'w'},
         {0, 0, 0, 0}
     };
     int longindex, next_option;
     int verbose = 0;
+    int state_interval = 0, max_staleness = 0;
+    int group_window = 0, group_size = 0;
     int retval = EXIT_SUCCESS, r;
     char *aux_string;
     struct sigaction action;
@@ -135,6 +158,9 @@ main(int argc, char **argv)
     while ((next_option = getopt_long(argc, argv, optstring, longopts,
                                       &longindex)) != -1) {
         switch (next_option) {
+        case 'b':
+            group_size = atoi(optarg);
+            break;
         case 'd':
             ovsdb_path = strdup(optarg);
             break;
@@ -144,15 +170,30 @@ main(int argc, char **argv)
         case 'h':
             print_usage(argv[0]);
             break;
+        case 'm':
+            max_staleness = atoi(optarg);
+            break;
+        case 's':
+            state_interval = atoi(optarg);
+            break;
+        case 't':
+            ofc_set_of_timeout(atoi(optarg));
+            break;
         case 'v':
             verbose = atoi(optarg);
             break;
+        case 'w':
+            group_window = atoi(optarg);
+            break;
         default:
             print_usage(argv[0]);
             break;
         }
     }
 
+    ofc_set_state_sampling(state_interval, max_staleness);
+    srv_set_group_commit(group_window, group_size);
+
     /* set signal handler */
     sigfillset(&block_mask);
     action.sa_handler = signal_handler;
@@ -245,6 +286,12 @@ main(int argc, char **argv)
         goto cleanup;
     }
 
+    /* counters and the state sample age augmenting the of-config data */
+    if (ncds_add_model(OFC_DATADIR "/of-config/ofc-statistics.yin") != 0) {
+        nc_verb_warning("Adding ofc-statistics model failed, the counters "
+                        "will not be available.");
+    }
+
     if (ncds_consolidate() != 0) {
         retval = EXIT_FAILURE;
         nc_verb_error("Consolidating data models failed.");
@@ -266,7 +313,12 @@ main(int argc, char **argv)
     nc_verb_verbose("OF-CONFIG server successfully initialized.");
 
     while (!mainloop) {
-        comm_loop(c, 500);
+        /* the agents, OVSDB and the bridges are not polled together, check
+         * the commit and the state sample in progress often */
+        comm_loop(c, ofc_commit_pending() || ofc_state_sample_pending()
+                     ? COMMIT_TIMEOUT : srv_timeout(TIMEOUT));
+        ofc_run();
+        srv_run();
     }
 
 cleanup:
@@ -15,6 +15,7 @@
  */
 
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <dbus/dbus.h>
@@ -159,6 +160,58 @@ cleanup:
     return ret;
 }
 
+/* Request waiting for its reply, see send_reply() */
+struct op_request {
+    DBusConnection *c;
+    DBusMessage *msg;
+};
+
+/* Send the reply of the operation to the agent, see srv_reply_clb */
+static void
+send_reply(void *ctx, nc_reply *reply)
+{
+    struct op_request *req = ctx;
+    DBusConnection *c = req->c;
+    DBusMessage *msg = req->msg;
+    DBusMessageIter args;
+    DBusMessage *dbus_reply;
+    char *replydump;
+
+    free(req);
+    if (reply == NULL) {
+        /* the agent is gone */
+        dbus_message_unref(msg);
+        return;
+    }
+
+    replydump = nc_reply_dump(reply);
+    if (replydump == NULL) {
+        nc_verb_error("Invalid rpc-reply to send via D-Bus");
+        _dbus_error_reply(msg, c, DBUS_ERROR_FAILED,
+                          "Invalid rpc-reply to send via D-Bus");
+        dbus_message_unref(msg);
+        return;
+    }
+
+    dbus_reply = dbus_message_new_method_return(msg);
+
+    dbus_message_iter_init_append(dbus_reply, &args);
+    if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &replydump)) {
+        nc_verb_error("Unable to set D-Bus rpc-reply message");
+        _dbus_error_reply(msg, c, DBUS_ERROR_FAILED,
+                          "Unable to create reply message content");
+        goto cleanup;
+    }
+
+    dbus_connection_send(c, dbus_reply, NULL);
+
+cleanup:
+    dbus_connection_flush(c);
+    free(replydump);
+    dbus_message_unref(dbus_reply);
+    dbus_message_unref(msg);
+}
+
 /**
  * @brief Handle standard D-Bus methods on standard interfaces
  * org.freedesktop.DBus.Peer, org.freedesktop.DBus.Introspectable
@@ -546,12 +599,11 @@ kill_session(DBusConnection *c, DBusMessage *msg)
 static void
 process_operation(DBusConnection *c, DBusMessage *msg)
 {
-    char *rpcdump, *replydump;
+    char *rpcdump;
     DBusMessageIter args;
-    DBusMessage *dbus_reply;
     struct agent_info *session;
+    struct op_request *req;
     nc_rpc *rpc = NULL;
-    nc_reply *reply;
 
     session = srv_get_agent_by_agentid(dbus_message_get_sender(msg));
     if (session == NULL) {
@@ -582,35 +634,18 @@ process_operation(DBusConnection *c, DBusMessage *msg)
     rpc = nc_rpc_build(rpcdump, session->session);
     nc_verb_verbose("Processing request %s", rpcdump);
 
-    reply = srv_process_rpc(session->session, rpc);
-
-    replydump = nc_reply_dump(reply);
-    nc_reply_free(reply);
-    nc_rpc_free(rpc);
-
-    if (replydump == NULL) {
-        nc_verb_error("Invalid rpc-reply to send via D-Bus");
-        _dbus_error_reply(msg, c, DBUS_ERROR_FAILED,
-                          "Invalid rpc-reply to send via D-Bus");
+    req = malloc(sizeof *req);
+    if (req == NULL) {
+        nc_verb_error("Memory allocation failed (%s).", __func__);
+        _dbus_error_reply(msg, c, DBUS_ERROR_FAILED, "Out of memory");
+        nc_rpc_free(rpc);
         return;
     }
+    req->c = c;
+    req->msg = dbus_message_ref(msg);
 
-    dbus_reply = dbus_message_new_method_return(msg);
-
-    dbus_message_iter_init_append(dbus_reply, &args);
-    if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &replydump)) {
-        nc_verb_error("Unable to set D-Bus rpc-reply message");
-        _dbus_error_reply(msg, c, DBUS_ERROR_FAILED,
-                          "Unable to create reply message content");
-        goto cleanup;
-    }
-
-    dbus_connection_send(c, dbus_reply, NULL);
-
-cleanup:
-    dbus_connection_flush(c);
-    free(replydump);
-    dbus_message_unref(dbus_reply);
+    /* the reply can wait for the commit of the changes into OVSDB */
+    srv_process_rpc_async(session->session, rpc, send_reply, req);
 }
 
 /* Main communication loop */
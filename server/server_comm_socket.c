@@ -17,6 +17,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <poll.h>
+#include <stdint.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -320,6 +321,32 @@ sendreply:
     free(ncsid2kill);
 }
 
+/* Send the reply of the generic operation to the agent, see srv_reply_clb */
+static void
+send_reply(void *ctx, nc_reply *reply)
+{
+    int socket = (intptr_t) ctx;
+    char *msg_dump;
+    msgtype_t result;
+
+    if (reply == NULL) {
+        /* the agent is gone */
+        return;
+    }
+    /* libnetconf serializes the whole reply, it is chunked only on the
+     * socket */
+    msg_dump = nc_reply_dump(reply);
+
+    /* send reply */
+    result = COMM_SOCK_GENERICOP;
+    send(socket, &result, sizeof result, OFC_SOCK_SENDFLAGS);
+
+    send_msg_chunked(socket, msg_dump, strlen(msg_dump));
+
+    /* cleanup */
+    free(msg_dump);
+}
+
 static void
 process_operation(int socket)
 {
@@ -330,7 +357,6 @@ process_operation(int socket)
     char id[6];
     nc_reply *reply;
     nc_rpc *rpc;
-    msgtype_t result;
 
     /* RPC dump */
     recv(socket, &len, sizeof len, OFC_SOCK_SENDFLAGS);
@@ -344,6 +370,7 @@ process_operation(int socket)
     if ((session = srv_get_agent_by_agentid(id)) == NULL) {
         /* something is wrong, the sender's session does not exist */
         nc_verb_error("Unknown session %s", id);
+        free(msg_dump);
         err = nc_err_new(NC_ERR_OP_FAILED);
         nc_err_set(err, NC_ERR_PARAM_MSG, "request from unknown agent");
         reply = nc_reply_error(err);
@@ -353,33 +380,14 @@ process_operation(int socket)
     rpc = nc_rpc_build(msg_dump, session->session);
     free(msg_dump);
 
-    if ((reply = srv_process_rpc(session->session, rpc)) == NULL) {
-        err = nc_err_new(NC_ERR_OP_FAILED);
-        nc_err_set(err, NC_ERR_PARAM_MSG,
-                   "For unknown reason no reply was returned by device.");
-        reply = nc_reply_error(err);
-    } else if (reply == NCDS_RPC_NOT_APPLICABLE) {
-        err = nc_err_new(NC_ERR_OP_FAILED);
-        nc_err_set(err, NC_ERR_PARAM_MSG,
-                   "There is no device/data that could be affected.");
-        reply = nc_reply_error(err);
-    }
-    nc_rpc_free(rpc);
+    /* the reply can wait for the commit of the changes into OVSDB */
+    srv_process_rpc_async(session->session, rpc, send_reply,
+                          (void *) (intptr_t) socket);
+    return;
 
 send_reply:
-    msg_dump = nc_reply_dump(reply);
+    send_reply((void *) (intptr_t) socket, reply);
     nc_reply_free(reply);
-
-    /* send reply */
-    result = COMM_SOCK_GENERICOP;
-    send(socket, &result, sizeof result, OFC_SOCK_SENDFLAGS);
-
-    len = strlen(msg_dump) + 1;
-    send(socket, &len, sizeof len, OFC_SOCK_SENDFLAGS);
-    send(socket, msg_dump, len, OFC_SOCK_SENDFLAGS);
-
-    /* cleanup */
-    free(msg_dump);
 }
 
 /* Main communication loop */
@@ -16,13 +16,286 @@
 
 #include <assert.h>
 #include <signal.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "server_ops.h"
+#include "data.h"
 
 /* Internal list of NETCONF sessions - agents connected via DBus */
 static struct agent_info *agents = NULL;
 
+/* Request waiting for its turn or for the commit of its changes */
+struct srv_request {
+    struct nc_session *session;
+    nc_rpc *rpc;                /* NULL once processed alone */
+    nc_reply *reply;
+    srv_reply_clb send;         /* NULL if the agent is gone */
+    void *ctx;
+    bool alone;                 /* not to be grouped with other edits */
+    unsigned int edit;          /* id of its edit in the commit, 0 if none */
+    struct srv_request *next;
+};
+
+/* Requests whose replies wait for the commit started by their processing */
+static struct srv_request *committing = NULL;
+
+/* Requests modifying the data, postponed until the commit finishes */
+static struct srv_request *requests = NULL;
+static struct srv_request **requests_tail = &requests;
+
+/* Group commit of the edit-configs of running, see srv_set_group_commit() */
+static struct {
+    int window;                 /* ms, 0 disables the grouping */
+    int size;                   /* maximal number of edits, 0 is unlimited */
+    long long int deadline;     /* when the collected edits are applied */
+    struct srv_request *members;
+    struct srv_request **tail;
+    int n_members;
+} group = {0, 0, 0, NULL, &group.members, 0};
+
+/* Monotonic time in milliseconds */
+static long long int
+srv_time_msec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long int) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Send the reply of the request (unless its agent is gone) and free it */
+static void
+srv_request_reply(struct srv_request *req)
+{
+    if (req->send) {
+        req->send(req->ctx, req->reply);
+    }
+    if (req->reply) {
+        nc_reply_free(req->reply);
+    }
+    if (req->rpc) {
+        nc_rpc_free(req->rpc);
+    }
+    free(req);
+}
+
+/* Forget the requests of the session in the list, returns its new tail */
+static struct srv_request **
+srv_requests_drop_list(struct srv_request **list, struct nc_session *session)
+{
+    struct srv_request **iter, *req;
+
+    for (iter = list; *iter; ) {
+        req = *iter;
+        if (req->session != session) {
+            iter = &req->next;
+            continue;
+        }
+        *iter = req->next;
+        req->send(req->ctx, NULL);
+        req->send = NULL;
+        srv_request_reply(req);
+    }
+    return iter;
+}
+
+/* Forget the requests of the session */
+static void
+srv_requests_drop(struct nc_session *session)
+{
+    struct srv_request *req;
+    int n = 0;
+
+    /* the changes are being committed, only the replies are dropped */
+    for (req = committing; req; req = req->next) {
+        if (req->session == session && req->send) {
+            req->send(req->ctx, NULL);
+            req->send = NULL;
+        }
+    }
+
+    requests_tail = srv_requests_drop_list(&requests, session);
+    group.tail = srv_requests_drop_list(&group.members, session);
+    for (req = group.members; req; req = req->next) {
+        n++;
+    }
+    group.n_members = n;
+}
+
+/* Put the list of requests in front of the postponed ones */
+static void
+srv_requests_push_front(struct srv_request *list)
+{
+    struct srv_request **tail;
+
+    if (!list) {
+        return;
+    }
+    for (tail = &list; *tail; tail = &(*tail)->next);
+    *tail = requests;
+    if (!requests) {
+        requests_tail = tail;
+    }
+    requests = list;
+}
+
+/* Queue the request until the commit in progress finishes */
+static void
+srv_requests_postpone(struct srv_request *req)
+{
+    nc_verb_verbose("Request postponed until the commit finishes.");
+    *requests_tail = req;
+    requests_tail = &req->next;
+}
+
+/* Execute the edits of the group again, each of them alone */
+static void
+srv_requests_retry(struct srv_request *list)
+{
+    struct srv_request **iter, *req;
+
+    for (iter = &list; *iter; ) {
+        req = *iter;
+        if (!req->send) {
+            /* the agent is gone */
+            *iter = req->next;
+            srv_request_reply(req);
+            continue;
+        }
+        if (req->reply) {
+            nc_reply_free(req->reply);
+            req->reply = NULL;
+        }
+        req->alone = true;
+        iter = &req->next;
+    }
+    srv_requests_push_front(list);
+}
+
+/* Process the RPC of the request and remember its edit of the commit */
+static void
+srv_request_apply(struct srv_request *req)
+{
+    unsigned int last = ofc_commit_last_edit();
+
+    req->reply = srv_process_rpc(req->session, req->rpc);
+    req->edit = ofc_commit_last_edit();
+    if (req->edit == last) {
+        /* it did not reach txn_commit_start(), e.g. no OVSDB changes */
+        req->edit = 0;
+    }
+}
+
+/* Process the request, its reply is parked if it started a commit */
+static void
+srv_request_process(struct srv_request *req)
+{
+    bool pending = ofc_commit_pending();
+
+    srv_request_apply(req);
+    nc_rpc_free(req->rpc);
+    req->rpc = NULL;
+
+    if (!pending && ofc_commit_pending()) {
+        committing = req;
+        return;
+    }
+    srv_request_reply(req);
+}
+
+/* Reply to the requests of the finished commit with its result */
+static void
+srv_commit_finish(int ret, struct nc_err *err)
+{
+    struct srv_request *req, *list = committing;
+
+    committing = NULL;
+    if (ret != EXIT_SUCCESS && list->next) {
+        /* find out which of the grouped edits failed */
+        nc_verb_verbose("Group commit failed, executing the edits alone.");
+        nc_err_free(err);
+        srv_requests_retry(list);
+        return;
+    }
+
+    while ((req = list) != NULL) {
+        list = req->next;
+        if (ret != EXIT_SUCCESS
+            || (req->edit
+                && ofc_commit_edit_result(req->edit, &err) != EXIT_SUCCESS)) {
+            /* the commit or the OpenFlow part of the edit failed */
+            nc_reply_free(req->reply);
+            req->reply = nc_reply_error(err);
+        }
+        srv_request_reply(req);
+    }
+}
+
+/* Apply the collected edits in a single transaction */
+static void
+srv_group_flush(void)
+{
+    struct srv_request *list = group.members, *req, *rest;
+    struct nc_err *err = NULL;
+    int ret;
+
+    group.members = NULL;
+    group.tail = &group.members;
+    group.n_members = 0;
+    if (!list->next) {
+        srv_request_process(list);
+        return;
+    }
+
+    txn_group_begin();
+    for (req = list; req; req = req->next) {
+        srv_request_apply(req);
+        if (nc_reply_get_type(req->reply) == NC_REPLY_ERROR) {
+            break;
+        }
+    }
+    if (req) {
+        /* the edit may fail because of the preceding ones, execute them
+         * alone and group the following ones again */
+        txn_group_abort();
+        rest = req->next;
+        req->next = NULL;
+        srv_requests_push_front(rest);
+        srv_requests_retry(list);
+        return;
+    }
+
+    ret = txn_group_end(&err);
+    committing = list;
+    if (!ofc_commit_pending()) {
+        srv_commit_finish(ret, err);
+    }
+}
+
+/* Add the edit-config of running into the group, false if it cannot be
+ * grouped */
+static bool
+srv_group_add(struct srv_request *req)
+{
+    if (!group.window || req->alone || !req->rpc
+        || nc_rpc_get_op(req->rpc) != NC_OP_EDITCONFIG
+        || nc_rpc_get_target(req->rpc) != NC_DATASTORE_RUNNING) {
+        return false;
+    }
+
+    if (!group.members) {
+        group.deadline = srv_time_msec() + group.window;
+    }
+    *group.tail = req;
+    group.tail = &req->next;
+    if (++group.n_members == group.size) {
+        srv_group_flush();
+    }
+    return true;
+}
+
 struct agent_info *
 srv_get_agent_by_ncsid(const char *id)
 {
@@ -101,6 +374,7 @@ srv_agent_stop(struct agent_info *agent)
     }
 
     /* close & free libnetconf session */
+    srv_requests_drop(agent->session);
     nc_session_free(agent->session);
 
     /* free agent structure */
@@ -127,7 +401,12 @@ srv_process_rpc(struct nc_session *session, const nc_rpc *rpc)
 
     struct nc_err *err;
 
-    if ((reply = ncds_apply_rpc2all(session, rpc, NULL)) == NULL) {
+    /* generate only the data the request's filter can select */
+    ofc_filter_set(rpc);
+    reply = ncds_apply_rpc2all(session, rpc, NULL);
+    ofc_filter_clear();
+
+    if (reply == NULL) {
         err = nc_err_new(NC_ERR_OP_FAILED);
         reply = nc_reply_error(err);
     } else if (reply == NCDS_RPC_NOT_APPLICABLE) {
@@ -139,3 +418,100 @@ srv_process_rpc(struct nc_session *session, const nc_rpc *rpc)
 
     return reply;
 }
+
+void
+srv_process_rpc_async(struct nc_session *session, nc_rpc *rpc,
+                      srv_reply_clb send, void *ctx)
+{
+    struct srv_request *req;
+    NC_OP op;
+
+    req = calloc(1, sizeof *req);
+    if (!req) {
+        nc_verb_error("Memory allocation failed (%s).", __func__);
+        nc_rpc_free(rpc);
+        send(ctx, NULL);
+        return;
+    }
+    req->session = session;
+    req->rpc = rpc;
+    req->send = send;
+    req->ctx = ctx;
+
+    /* the reads are served from the last committed data, the changes wait
+     * for the commit in progress and for the collected edits */
+    op = rpc ? nc_rpc_get_op(rpc) : NC_OP_UNKNOWN;
+    if (op == NC_OP_GET && committing && !ofc_state_sampled()) {
+        /* without a sample, the state is read from OVSDB's local copy which
+         * already shows the changes being committed */
+        srv_requests_postpone(req);
+        return;
+    } else if (op != NC_OP_GET && op != NC_OP_GETCONFIG) {
+        if (!committing && !requests && srv_group_add(req)) {
+            return;
+        } else if (committing || requests || group.members) {
+            srv_requests_postpone(req);
+            return;
+        }
+    }
+
+    srv_request_process(req);
+}
+
+void
+srv_run(void)
+{
+    struct srv_request *req;
+    struct nc_err *err;
+    int ret;
+
+    if (committing) {
+        if (!ofc_commit_done(&ret, &err)) {
+            return;
+        }
+        srv_commit_finish(ret, err);
+    }
+
+    while (!committing) {
+        if (requests) {
+            req = requests;
+            requests = req->next;
+            if (!requests) {
+                requests_tail = &requests;
+            }
+            req->next = NULL;
+            if (srv_group_add(req)) {
+                continue;
+            } else if (group.members) {
+                /* keep the order of the requests */
+                srv_requests_push_front(req);
+                srv_group_flush();
+                continue;
+            }
+            srv_request_process(req);
+        } else if (group.members && srv_time_msec() >= group.deadline) {
+            srv_group_flush();
+        } else {
+            break;
+        }
+    }
+}
+
+int
+srv_timeout(int timeout)
+{
+    long long int left;
+
+    if (!group.members) {
+        return timeout;
+    }
+    left = group.deadline - srv_time_msec();
+    return left < 0 ? 0 : left < timeout ? left : timeout;
+}
+
+void
+srv_set_group_commit(int window, int size)
+{
+    group.window = window < 0 ? 0 : window;
+    group.size = size < 0 ? 0 : size;
+}
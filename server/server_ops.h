@@ -43,6 +43,59 @@ struct agent_info {
  */
 nc_reply *srv_process_rpc(struct nc_session *session, const nc_rpc *rpc);
 
+/**
+ * @brief Send the reply of an asynchronously processed request
+ *
+ * @param[in] ctx Context given to srv_process_rpc_async()
+ * @param[in] reply Reply to send, NULL if the request was dropped. The reply
+ * stays owned by the caller, the context is released by the callback.
+ */
+typedef void (*srv_reply_clb)(void *ctx, nc_reply *reply);
+
+/**
+ * @brief Process NETCONF RPC request without waiting for OVSDB
+ *
+ * The reply of a request committing changes into OVSDB is sent once the
+ * commit finishes (see srv_run()). Meanwhile the read requests are served
+ * from the last committed data and the other requests are postponed.
+ *
+ * @param[in] session Session that sends rpc
+ * @param[in] rpc RPC to apply, it is freed by the function
+ * @param[in] send Callback sending the reply
+ * @param[in] ctx Context for the callback
+ */
+void srv_process_rpc_async(struct nc_session *session, nc_rpc *rpc,
+                           srv_reply_clb send, void *ctx);
+
+/**
+ * @brief Send the reply waiting for a finished commit and process the
+ * postponed requests, to be called from the server's main loop after
+ * ofc_run().
+ */
+void srv_run(void);
+
+/**
+ * @brief Get the timeout for waiting on the agents
+ *
+ * @param[in] timeout Default timeout, ms
+ *
+ * @return Timeout shortened to the end of the group commit window
+ */
+int srv_timeout(int timeout);
+
+/**
+ * @brief Set the group commit of edit-configs
+ *
+ * The edit-configs of running arriving within the window are applied in a
+ * single OVSDB transaction, each of them still gets its own reply. When the
+ * transaction fails, the edits are executed again one by one to find out
+ * which of them failed.
+ *
+ * @param[in] window Window collecting the edits in ms, 0 disables grouping
+ * @param[in] size Maximal number of edits in a group, 0 means no limit
+ */
+void srv_set_group_commit(int window, int size);
+
 /**
  * @brief Get pointer to the session info structure specified by NETCONF
  * session ID